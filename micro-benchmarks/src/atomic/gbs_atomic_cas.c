@@ -1,6 +1,7 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
 
 int main(int argc, char* argv[]) {
@@ -38,8 +39,7 @@ int main(int argc, char* argv[]) {
 
 	old = malloc(options.iterations * sizeof(char));
 	new = malloc(options.iterations * sizeof(char));
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id = 0;
 	const gaspi_queue_id_t q_id = 0;
@@ -52,7 +52,7 @@ int main(int argc, char* argv[]) {
 
 	allocate_gaspi_memory_initialized(segment_id, sizeof(size_t));
 	GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
-	for (i = 0; i < options.iterations + options.skip; ++i) {
+	for (i = 0; measure_continue(&measurements, i, MEASURE_COLLECTIVE); ++i) {
 		if (my_id == 0) {
 			if (i >= options.skip) {
 				time = stopwatch_start();
@@ -66,7 +66,10 @@ int main(int argc, char* argv[]) {
 			                              (gaspi_atomic_value_t*) &old_value,
 			                              GASPI_BLOCK));
 			if (i >= options.skip) {
-				measurements.time[i - options.skip] = stopwatch_stop(time);
+				record_measurement(&measurements,
+				                   i - options.skip,
+				                   time,
+				                   stopwatch_stop(time));
 			}
 			comparator = new_value++;
 		}
@@ -76,7 +79,8 @@ int main(int argc, char* argv[]) {
 		GASPI_CHECK(gaspi_read(
 		    segment_id, 0, 1, segment_id, 0, sizeof(size_t), 0, GASPI_BLOCK));
 		GASPI_CHECK(gaspi_wait(0, GASPI_BLOCK));
-		size_t expected_counter_val = options.iterations + options.skip;
+		// one operation per performed iteration
+		size_t expected_counter_val = i;
 		size_t actual_counter_val = *((size_t*) ptr);
 
 		if (actual_counter_val != expected_counter_val) {
@@ -92,7 +96,7 @@ int main(int argc, char* argv[]) {
 
 	print_atomic_lat(my_id, measurements);
 	free_gaspi_memory(segment_id);
-	free(measurements.time);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
@@ -2,6 +2,8 @@
 #include "stopwatch.h"
 #include "util.h"
 #include "util_memory.h"
+#include "util_placement.h"
+#include "util_sweep.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
@@ -32,13 +34,14 @@ int main(int argc, char* argv[]) {
 	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
 	GASPI_CHECK(gaspi_proc_rank(&my_id));
 	GASPI_CHECK(gaspi_proc_num(&num_pes));
+	placement_init();
 
 	print_header(my_id);
 
 	GASPI_CHECK(gaspi_allreduce_elem_max(&max_elem));
 	if (options.max_message_size > max_elem) {
 		if (my_id == 0) {
-			fprintf(stdout,
+			fprintf(stderr,
 			        "limit for allreduce is %d requested was %ld\n",
 			        max_elem,
 			        options.max_message_size);
@@ -51,8 +54,7 @@ int main(int argc, char* argv[]) {
 		                options.max_message_size * sizeof(float));
 		allocate_memory((void**) &recv_buffer,
 		                options.max_message_size * sizeof(float));
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
 			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
 
 			for (i = 0; i < options.iterations + options.skip; ++i) {
@@ -107,8 +109,7 @@ int main(int argc, char* argv[]) {
 		free_memory(recv_buffer);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
 			allocate_memory((void**) &send_buffer, size * sizeof(float));
 			allocate_memory((void**) &recv_buffer, size * sizeof(float));
 
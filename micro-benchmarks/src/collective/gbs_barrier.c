@@ -2,6 +2,7 @@
 #include "stopwatch.h"
 #include "util.h"
 #include "util_memory.h"
+#include "util_placement.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
@@ -27,6 +28,7 @@ int main(int argc, char* argv[]) {
 	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
 	GASPI_CHECK(gaspi_proc_rank(&my_id));
 	GASPI_CHECK(gaspi_proc_num(&num_pes));
+	placement_init();
 
 	print_header(my_id);
 
@@ -0,0 +1,228 @@
+#include <string.h>
+#include "check.h"
+#include "kernel.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_placement.h"
+#include "util_sweep.h"
+#include "util_sync.h"
+
+static void time_iterations(const struct kernel_t* kernel,
+                            const gaspi_rank_t id,
+                            const size_t size,
+                            struct measurements_t* measurements) {
+	double time;
+	int i;
+
+	for (i = 0; measure_continue(measurements, i, MEASURE_COLLECTIVE); ++i) {
+		if (i >= options.skip) {
+			time = stopwatch_start();
+		}
+		kernel->iterate(id, size, i);
+		if (i >= options.skip) {
+			record_measurement(
+			    measurements, i - options.skip, time, stopwatch_stop(time));
+		}
+	}
+}
+
+static void prepare_kernel(const struct kernel_t* kernel,
+                           const gaspi_rank_t id,
+                           const size_t size) {
+	if (options.verify && kernel->prepare != NULL) {
+		kernel->prepare(id, size);
+	}
+}
+
+static int verify_kernel(const struct kernel_t* kernel,
+                         const gaspi_rank_t id,
+                         const size_t size) {
+	int failed = 0;
+
+	if (options.verify && kernel->verify != NULL) {
+		GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+		failed = kernel->verify(id, size);
+		if (failed) {
+			fprintf(stderr,
+			        "%s: Verification failed. Result is invalid!\n",
+			        kernel->name);
+		}
+	}
+	return failed;
+}
+
+static int run_kernel(const struct kernel_t* kernel,
+                      const gaspi_rank_t id,
+                      struct measurements_t* measurements) {
+	size_t size;
+	int window_size;
+
+	options.type = kernel->type;
+	options.subtype = kernel->subtype;
+	options.name = (char*) kernel->name;
+
+	if (id == 0 && options.format == PLAIN) {
+		if (placement_node() != PLACEMENT_ANY) {
+			fprintf(stdout,
+			        "# %s (NUMA node %d)\n",
+			        kernel->name,
+			        placement_node());
+		}
+		else {
+			fprintf(stdout, "# %s\n", kernel->name);
+		}
+	}
+	pair_sync_enable(kernel->bidirectional);
+	print_header(id);
+
+	if (kernel->type == ATOMIC || kernel->type == NOTIFY) {
+		kernel->setup(id, 0);
+		time_iterations(kernel, id, 0, measurements);
+		if (verify_kernel(kernel, id, 0)) {
+			kernel->teardown(id, 0);
+			return EXIT_FAILURE;
+		}
+		if (kernel->type == ATOMIC) {
+			print_atomic_lat(id, *measurements);
+		}
+		else {
+			print_notify_lat(id, *measurements);
+		}
+		kernel->teardown(id, 0);
+		return EXIT_SUCCESS;
+	}
+
+	if (options.single_buffer) {
+		kernel->setup(id, options.max_message_size);
+	}
+	else if (options.arena) {
+		// registers the largest footprint of the kernel's segments once
+		window_size = options.window_size;
+		options.window_size = sweep_max_window();
+		kernel->setup(id, options.max_message_size);
+		kernel->teardown(id, options.max_message_size);
+		options.window_size = window_size;
+	}
+	for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+		if (!options.single_buffer) {
+			kernel->setup(id, size);
+		}
+		prepare_kernel(kernel, id, size);
+		GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+		time_iterations(kernel, id, size, measurements);
+		if (verify_kernel(kernel, id, size)) {
+			kernel->teardown(
+			    id, options.single_buffer ? options.max_message_size : size);
+			return EXIT_FAILURE;
+		}
+		print_result(
+		    id, *measurements, kernel->bidirectional ? size * 2 : size);
+		if (!options.single_buffer) {
+			kernel->teardown(id, size);
+		}
+	}
+	if (options.single_buffer) {
+		kernel->teardown(id, options.max_message_size);
+	}
+	return EXIT_SUCCESS;
+}
+
+// --numa-sweep runs every kernel with the segments in both places
+static const int sweep_nodes[] = {PLACEMENT_NIC, PLACEMENT_REMOTE};
+
+static const char* const default_kernels =
+    "gbs_write_bw,gbs_write_lat,gbs_write_bibw,gbs_read_bw,gbs_read_lat,"
+    "gbs_write_notify_bw,gbs_write_notify_lat,gbs_atomic_fadd,gbs_atomic_cas,"
+    "gbs_notification_rate,gbs_notification_ping_pong";
+
+// resolve the kernel list before paying for the GASPI initialization
+static int parse_kernels(const struct kernel_t*** list, int* n) {
+	char *kernels, *name, *saveptr;
+	int count = 1;
+	const char* c;
+
+	kernels = strdup(strcmp(options.kernels, "all") == 0 ? default_kernels
+	                                                      : options.kernels);
+	for (c = kernels; *c != '\0'; ++c) {
+		count += *c == ',';
+	}
+	*list = malloc(count * sizeof(**list));
+	*n = 0;
+	for (name = strtok_r(kernels, ",", &saveptr); name != NULL;
+	     name = strtok_r(NULL, ",", &saveptr)) {
+		(*list)[*n] = find_kernel(name);
+		if ((*list)[*n] == NULL) {
+			fprintf(stderr, "Unknown kernel %s\n", name);
+			free(kernels);
+			return OPTIONS_BAD_USAGE;
+		}
+		++*n;
+	}
+	free(kernels);
+	return OPTIONS_OKAY;
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, num_pes;
+	int bo_ret = OPTIONS_OKAY;
+	int ret = EXIT_SUCCESS;
+	int k, n, num_kernels;
+	const struct kernel_t** kernels;
+	struct measurements_t measurements;
+
+	options.type = DRIVER;
+	options.subtype = BW;
+	options.name = "gbs";
+
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			print_kernels();
+			return EXIT_SUCCESS;
+	}
+
+	if (options.list_kernels) {
+		print_kernels();
+		return EXIT_SUCCESS;
+	}
+
+	if (parse_kernels(&kernels, &num_kernels) != OPTIONS_OKAY) {
+		print_kernels();
+		free(kernels);
+		return EXIT_FAILURE;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	if (num_pes > 2) {
+		fprintf(stderr, "Benchmark requires exactly two processes!\n");
+		return EXIT_FAILURE;
+	}
+
+	init_measurements(&measurements);
+
+	for (k = 0; k < num_kernels && ret == EXIT_SUCCESS; ++k) {
+		if (!options.numa_sweep) {
+			ret = run_kernel(kernels[k], my_id, &measurements);
+			continue;
+		}
+		for (n = 0; n < 2 && ret == EXIT_SUCCESS; ++n) {
+			placement_set_node(sweep_nodes[n]);
+			ret = run_kernel(kernels[k], my_id, &measurements);
+		}
+	}
+
+	free(kernels);
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return ret;
+}
@@ -0,0 +1,32 @@
+#include "kernel.h"
+#include <string.h>
+
+static const struct kernel_t* const kernel_tables[] = {
+    one_sided_kernels, atomic_kernels, notification_kernels, NULL};
+
+const struct kernel_t* find_kernel(const char* name) {
+	const struct kernel_t* kernel;
+	int t;
+
+	for (t = 0; kernel_tables[t] != NULL; ++t) {
+		for (kernel = kernel_tables[t]; kernel->name != NULL; ++kernel) {
+			if (strcmp(kernel->name, name) == 0) {
+				return kernel;
+			}
+		}
+	}
+	return NULL;
+}
+
+void print_kernels(void) {
+	const struct kernel_t* kernel;
+	int t;
+
+	fprintf(stdout, "Available kernels:\n");
+	for (t = 0; kernel_tables[t] != NULL; ++t) {
+		for (kernel = kernel_tables[t]; kernel->name != NULL; ++kernel) {
+			fprintf(stdout, "\t%s\n", kernel->name);
+		}
+	}
+	fflush(stdout);
+}
@@ -0,0 +1,41 @@
+#ifndef __KERNEL_H__
+#define __KERNEL_H__
+
+#include <GASPI.h>
+#include <stddef.h>
+#include "util.h"
+
+/*
+ * A kernel is one benchmark of the suite split into callbacks so that the
+ * gbs driver can run several of them inside a single GASPI session.
+ *
+ * setup/teardown are called once per message size (once for the whole sweep
+ * with the maximum size in single buffer mode), iterate is called once per
+ * iteration on every rank and must only contain the work that is timed.
+ * verify is optional and returns 0 if the transferred data is valid, prepare
+ * is optional and places the pattern verify expects before the iterations of
+ * every message size. Both are only called with --verify.
+ * Bidirectional kernels move twice the message size per iteration and end it
+ * with pair_sync.
+ * Kernels of type ATOMIC and NOTIFY have no message size and are called with
+ * a size of 0.
+ */
+struct kernel_t {
+	const char* name;
+	enum benchmark_type type;
+	enum benchmark_subtype subtype;
+	int bidirectional;
+	void (*setup)(const gaspi_rank_t id, const size_t size);
+	void (*iterate)(const gaspi_rank_t id, const size_t size, const int i);
+	void (*prepare)(const gaspi_rank_t id, const size_t size);
+	int (*verify)(const gaspi_rank_t id, const size_t size);
+	void (*teardown)(const gaspi_rank_t id, const size_t size);
+};
+
+extern const struct kernel_t one_sided_kernels[];
+extern const struct kernel_t atomic_kernels[];
+extern const struct kernel_t notification_kernels[];
+
+const struct kernel_t* find_kernel(const char* name);
+void print_kernels(void);
+#endif
@@ -0,0 +1,95 @@
+#include "check.h"
+#include "kernel.h"
+#include "util_memory.h"
+
+static const gaspi_segment_id_t segment_id = 0;
+static gaspi_pointer_t ptr;
+static size_t new_value;
+static size_t comparator;
+static int issued;
+
+static void atomic_setup(const gaspi_rank_t id, const size_t size) {
+	allocate_gaspi_memory_initialized(segment_id, sizeof(size_t));
+	GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+	new_value = 1;
+	comparator = 0;
+	issued = 0;
+}
+
+static void atomic_teardown(const gaspi_rank_t id, const size_t size) {
+	free_gaspi_memory(segment_id);
+}
+
+static int atomic_verify(const gaspi_rank_t id, const size_t size) {
+	size_t actual_counter_val;
+
+	if (id != 0) {
+		return 0;
+	}
+	GASPI_CHECK(gaspi_read(
+	    segment_id, 0, 1, segment_id, 0, sizeof(size_t), 0, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_wait(0, GASPI_BLOCK));
+	actual_counter_val = *((size_t*) ptr);
+	if (actual_counter_val != (size_t) issued) {
+		fprintf(stderr,
+		        "Error: expected result is %d but actual result is %zu\n",
+		        issued,
+		        actual_counter_val);
+		return 1;
+	}
+	return 0;
+}
+
+static void fetch_add_iterate(const gaspi_rank_t id,
+                              const size_t size,
+                              const int i) {
+	gaspi_atomic_value_t old_value;
+
+	if (id != 0) {
+		return;
+	}
+	GASPI_CHECK(gaspi_atomic_fetch_add(
+	    segment_id, 0, 1, 1, &old_value, GASPI_BLOCK));
+	++issued;
+}
+
+static void compare_swap_iterate(const gaspi_rank_t id,
+                                 const size_t size,
+                                 const int i) {
+	gaspi_atomic_value_t old_value;
+
+	if (id != 0) {
+		return;
+	}
+	GASPI_CHECK(gaspi_atomic_compare_swap(segment_id,
+	                                      0,
+	                                      1,
+	                                      (gaspi_atomic_value_t) comparator,
+	                                      (gaspi_atomic_value_t) new_value,
+	                                      &old_value,
+	                                      GASPI_BLOCK));
+	comparator = new_value++;
+	++issued;
+}
+
+const struct kernel_t atomic_kernels[] = {
+    {"gbs_atomic_fadd",
+     ATOMIC,
+     LAT,
+     0,
+     atomic_setup,
+     fetch_add_iterate,
+     NULL,
+     atomic_verify,
+     atomic_teardown},
+    {"gbs_atomic_cas",
+     ATOMIC,
+     LAT,
+     0,
+     atomic_setup,
+     compare_swap_iterate,
+     NULL,
+     atomic_verify,
+     atomic_teardown},
+    {NULL}};
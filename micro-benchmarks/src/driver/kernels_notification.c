@@ -0,0 +1,85 @@
+#include "check.h"
+#include "kernel.h"
+#include "util_memory.h"
+
+static const gaspi_segment_id_t segment_id = 0;
+static const gaspi_queue_id_t q_id = 0;
+static const gaspi_notification_t notification_val = 1;
+
+static void notification_setup(const gaspi_rank_t id, const size_t size) {
+	allocate_gaspi_memory(segment_id, sizeof(char), 'a');
+}
+
+static void notification_teardown(const gaspi_rank_t id, const size_t size) {
+	free_gaspi_memory(segment_id);
+}
+
+static void rate_iterate(const gaspi_rank_t id,
+                         const size_t size,
+                         const int i) {
+	gaspi_notification_id_t first;
+	int j;
+
+	if (id == 0) {
+		for (j = 0; j < options.window_size; ++j) {
+			GASPI_CHECK(gaspi_notify(
+			    segment_id, 1, j, notification_val, q_id, GASPI_BLOCK));
+		}
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	}
+	else {
+		GASPI_CHECK(gaspi_notify_waitsome(
+		    segment_id, 0, options.window_size, &first, GASPI_BLOCK));
+	}
+}
+
+// adaptive runs may outlast the ids, every id is reset for its next use
+static void ping_pong_iterate(const gaspi_rank_t id,
+                              const size_t size,
+                              const int i) {
+	gaspi_notification_id_t notification_id, first;
+	gaspi_notification_t value;
+	gaspi_number_t notification_num;
+
+	GASPI_CHECK(gaspi_notification_num(&notification_num));
+	notification_id = i % notification_num;
+	if (id == 0) {
+		GASPI_CHECK(gaspi_notify(segment_id,
+		                         1,
+		                         notification_id,
+		                         notification_val,
+		                         q_id,
+		                         GASPI_BLOCK));
+		GASPI_CHECK(gaspi_notify_waitsome(
+		    segment_id, notification_id, 1, &first, GASPI_BLOCK));
+	}
+	else {
+		GASPI_CHECK(gaspi_notify_waitsome(
+		    segment_id, notification_id, 1, &first, GASPI_BLOCK));
+		GASPI_CHECK(gaspi_notify(
+		    segment_id, 0, notification_id, id, q_id, GASPI_BLOCK));
+	}
+	GASPI_CHECK(gaspi_notify_reset(segment_id, notification_id, &value));
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+}
+
+const struct kernel_t notification_kernels[] = {
+    {"gbs_notification_rate",
+     NOTIFY,
+     RATE,
+     0,
+     notification_setup,
+     rate_iterate,
+     NULL,
+     NULL,
+     notification_teardown},
+    {"gbs_notification_ping_pong",
+     NOTIFY,
+     PINGPONG,
+     0,
+     notification_setup,
+     ping_pong_iterate,
+     NULL,
+     NULL,
+     notification_teardown},
+    {NULL}};
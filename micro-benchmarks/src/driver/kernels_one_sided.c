@@ -0,0 +1,282 @@
+#include "check.h"
+#include "kernel.h"
+#include "util_memory.h"
+#include "util_offsets.h"
+#include "util_sync.h"
+#include "util_verify.h"
+
+static const gaspi_segment_id_t segment_id = 0;
+static const gaspi_segment_id_t segment_id_recv = 1;
+static const gaspi_queue_id_t q_id = 0;
+static const gaspi_notification_t notification_val = 1;
+static const gaspi_notification_id_t notification_id = 0;
+
+static size_t buffer_size(const size_t size) {
+	if (options.subtype == BW && !options.single_buffer) {
+		return offsets_footprint(size * options.window_size);
+	}
+	return offsets_footprint(size);
+}
+
+static gaspi_offset_t window_offset(const size_t size, const int j) {
+	return offsets_next(size, options.single_buffer ? 0 : j * size);
+}
+
+static void one_sided_setup(const gaspi_rank_t id, const size_t size) {
+	allocate_gaspi_memory(
+	    segment_id, buffer_size(size) * sizeof(char), id == 0 ? 'a' : 'b');
+}
+
+static void one_sided_teardown(const gaspi_rank_t id, const size_t size) {
+	free_gaspi_memory(segment_id);
+}
+
+// rank 0 writes the pattern of the size to rank 1
+static void write_prepare(const gaspi_rank_t id, const size_t size) {
+	verify_prepare(segment_id, buffer_size(size), 0, size);
+}
+
+static int write_verify(const gaspi_rank_t id, const size_t size) {
+	return !verify_received(segment_id, buffer_size(size), 0, size);
+}
+
+// rank 0 reads the pattern of the size from rank 1
+static void read_prepare(const gaspi_rank_t id, const size_t size) {
+	verify_prepare(segment_id, buffer_size(size), 1, size);
+}
+
+static int read_verify(const gaspi_rank_t id, const size_t size) {
+	return !verify_received(segment_id, buffer_size(size), 1, size);
+}
+
+static void write_bw_iterate(const gaspi_rank_t id,
+                             const size_t size,
+                             const int i) {
+	gaspi_offset_t offset;
+	int j;
+
+	if (id != 0) {
+		return;
+	}
+	for (j = 0; j < options.window_size; ++j) {
+		offset = window_offset(size, j);
+		GASPI_CHECK(gaspi_write(segment_id,
+		                        offset,
+		                        1,
+		                        segment_id,
+		                        offset,
+		                        size,
+		                        q_id,
+		                        GASPI_BLOCK));
+	}
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+}
+
+static void write_lat_iterate(const gaspi_rank_t id,
+                              const size_t size,
+                              const int i) {
+	const gaspi_offset_t offset = offsets_next(size, 0);
+
+	if (id != 0) {
+		return;
+	}
+	GASPI_CHECK(gaspi_write(
+	    segment_id, offset, 1, segment_id, offset, size, q_id, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+}
+
+static void read_bw_iterate(const gaspi_rank_t id,
+                            const size_t size,
+                            const int i) {
+	gaspi_offset_t offset;
+	int j;
+
+	if (id != 0) {
+		return;
+	}
+	for (j = 0; j < options.window_size; ++j) {
+		offset = window_offset(size, j);
+		GASPI_CHECK(gaspi_read(segment_id,
+		                       offset,
+		                       1,
+		                       segment_id,
+		                       offset,
+		                       size,
+		                       q_id,
+		                       GASPI_BLOCK));
+	}
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+}
+
+static void read_lat_iterate(const gaspi_rank_t id,
+                             const size_t size,
+                             const int i) {
+	const gaspi_offset_t offset = offsets_next(size, 0);
+
+	if (id != 0) {
+		return;
+	}
+	GASPI_CHECK(gaspi_read(
+	    segment_id, offset, 1, segment_id, offset, size, q_id, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+}
+
+static void write_notify_bw_iterate(const gaspi_rank_t id,
+                                    const size_t size,
+                                    const int i) {
+	gaspi_offset_t offset;
+	int j;
+
+	if (id != 0) {
+		return;
+	}
+	for (j = 0; j < options.window_size; ++j) {
+		offset = window_offset(size, j);
+		GASPI_CHECK(gaspi_write_notify(segment_id,
+		                               offset,
+		                               1,
+		                               segment_id,
+		                               offset,
+		                               size,
+		                               notification_id,
+		                               notification_val,
+		                               q_id,
+		                               GASPI_BLOCK));
+	}
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+}
+
+static void write_notify_lat_iterate(const gaspi_rank_t id,
+                                     const size_t size,
+                                     const int i) {
+	const gaspi_offset_t offset = offsets_next(size, 0);
+
+	if (id != 0) {
+		return;
+	}
+	GASPI_CHECK(gaspi_write_notify(segment_id,
+	                               offset,
+	                               1,
+	                               segment_id,
+	                               offset,
+	                               size,
+	                               notification_id,
+	                               notification_val,
+	                               q_id,
+	                               GASPI_BLOCK));
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+}
+
+static void write_bibw_setup(const gaspi_rank_t id, const size_t size) {
+	allocate_gaspi_memory(
+	    segment_id, buffer_size(size) * sizeof(char), id == 0 ? 'a' : 'b');
+	allocate_gaspi_memory(
+	    segment_id_recv, buffer_size(size) * sizeof(char), 'y');
+	pair_sync_calibrate(segment_id_recv, id == 0 ? 1 : 0, q_id);
+}
+
+static void write_bibw_iterate(const gaspi_rank_t id,
+                               const size_t size,
+                               const int i) {
+	gaspi_offset_t offset;
+	int j;
+
+	for (j = 0; j < options.window_size; ++j) {
+		offset = window_offset(size, j);
+		GASPI_CHECK(gaspi_write(segment_id,
+		                        offset,
+		                        id == 0 ? 1 : 0,
+		                        segment_id_recv,
+		                        offset,
+		                        size,
+		                        q_id,
+		                        GASPI_BLOCK));
+	}
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	pair_sync(segment_id_recv, id == 0 ? 1 : 0, q_id);
+}
+
+// both ranks send their own pattern and receive the partner's
+static void write_bibw_prepare(const gaspi_rank_t id, const size_t size) {
+	verify_fill(segment_id, 0, buffer_size(size), verify_seed(id, size, 0));
+	verify_clear(segment_id_recv, 0, buffer_size(size));
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+}
+
+static int write_bibw_verify(const gaspi_rank_t id, const size_t size) {
+	return !verify_check(segment_id_recv,
+	                     0,
+	                     buffer_size(size),
+	                     verify_seed(id == 0 ? 1 : 0, size, 0));
+}
+
+static void write_bibw_teardown(const gaspi_rank_t id, const size_t size) {
+	free_gaspi_memory(segment_id);
+	free_gaspi_memory(segment_id_recv);
+}
+
+const struct kernel_t one_sided_kernels[] = {
+    {"gbs_write_bw",
+     ONESIDED,
+     BW,
+     0,
+     one_sided_setup,
+     write_bw_iterate,
+     write_prepare,
+     write_verify,
+     one_sided_teardown},
+    {"gbs_write_lat",
+     ONESIDED,
+     LAT,
+     0,
+     one_sided_setup,
+     write_lat_iterate,
+     write_prepare,
+     write_verify,
+     one_sided_teardown},
+    {"gbs_write_bibw",
+     ONESIDED,
+     BW,
+     1,
+     write_bibw_setup,
+     write_bibw_iterate,
+     write_bibw_prepare,
+     write_bibw_verify,
+     write_bibw_teardown},
+    {"gbs_read_bw",
+     ONESIDED,
+     BW,
+     0,
+     one_sided_setup,
+     read_bw_iterate,
+     read_prepare,
+     read_verify,
+     one_sided_teardown},
+    {"gbs_read_lat",
+     ONESIDED,
+     LAT,
+     0,
+     one_sided_setup,
+     read_lat_iterate,
+     read_prepare,
+     read_verify,
+     one_sided_teardown},
+    {"gbs_write_notify_bw",
+     ONESIDED,
+     BW,
+     0,
+     one_sided_setup,
+     write_notify_bw_iterate,
+     write_prepare,
+     write_verify,
+     one_sided_teardown},
+    {"gbs_write_notify_lat",
+     ONESIDED,
+     LAT,
+     0,
+     one_sided_setup,
+     write_notify_lat_iterate,
+     write_prepare,
+     write_verify,
+     one_sided_teardown},
+    {NULL}};
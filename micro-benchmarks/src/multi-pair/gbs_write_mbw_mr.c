@@ -0,0 +1,85 @@
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_memory.h"
+#include "util_pairs.h"
+#include "util_sweep.h"
+
+/*
+ * Bandwidth and message rate of all rank pairs writing windows at once, as
+ * osu_mbw_mr. Every sender measures its own pair, the pairs only meet in the
+ * barrier of the segment allocation before every message size.
+ */
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, partner;
+	size_t size;
+	int i, j;
+	int bo_ret = OPTIONS_OKAY;
+	double time;
+	struct measurements_t measurements;
+
+	options.type = MULTIPAIR;
+	options.subtype = BW;
+	options.name = "gbs_write_mbw_mr";
+
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+
+	pairs_init();
+	init_measurements(&measurements);
+
+	const gaspi_segment_id_t segment_id = 0;
+	const gaspi_queue_id_t q_id = 0;
+
+	print_header(my_id);
+
+	reserve_gaspi_memory(segment_id,
+	                     options.max_message_size * options.window_size);
+	for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+		allocate_gaspi_memory(segment_id, size * options.window_size, 'a');
+		if (pairs_sender()) {
+			partner = pairs_partner();
+			for (i = 0; measure_continue(&measurements, i, MEASURE_LOCAL);
+			     ++i) {
+				if (i >= options.skip) {
+					time = stopwatch_start();
+				}
+				for (j = 0; j < options.window_size; ++j) {
+					GASPI_CHECK(gaspi_write(segment_id,
+					                        j * size,
+					                        partner,
+					                        segment_id,
+					                        j * size,
+					                        size,
+					                        q_id,
+					                        GASPI_BLOCK));
+				}
+				GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+				if (i >= options.skip) {
+					record_measurement(&measurements,
+					                   i - options.skip,
+					                   time,
+					                   stopwatch_stop(time));
+				}
+			}
+		}
+		print_pair_result(my_id, measurements, size);
+		free_gaspi_memory(segment_id);
+	}
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
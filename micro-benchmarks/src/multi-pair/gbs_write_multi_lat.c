@@ -0,0 +1,103 @@
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_memory.h"
+#include "util_pairs.h"
+#include "util_sweep.h"
+
+/*
+ * Latency of all rank pairs exchanging gaspi_write_notify ping-pongs at once,
+ * as osu_multi_lat. The sender times the round trip and records half of it.
+ */
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, partner;
+	size_t size;
+	int i;
+	int bo_ret = OPTIONS_OKAY;
+	double time;
+	struct measurements_t measurements;
+
+	options.type = MULTIPAIR;
+	options.subtype = LAT;
+	options.name = "gbs_write_multi_lat";
+
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+
+	pairs_init();
+	init_measurements(&measurements);
+
+	const gaspi_segment_id_t segment_id = 0;
+	const gaspi_queue_id_t q_id = 0;
+	const gaspi_notification_id_t notification_id = 0;
+	gaspi_notification_id_t first;
+	gaspi_notification_t value;
+
+	print_header(my_id);
+
+	reserve_gaspi_memory(segment_id, options.max_message_size);
+	for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+		allocate_gaspi_memory(segment_id, size, 'a');
+		if (pairs_index() != PAIRS_NONE) {
+			partner = pairs_partner();
+			for (i = 0; measure_continue(&measurements, i, MEASURE_LOCAL);
+			     ++i) {
+				if (pairs_sender() && i >= options.skip) {
+					time = stopwatch_start();
+				}
+				if (pairs_sender()) {
+					GASPI_CHECK(gaspi_write_notify(segment_id,
+					                               0,
+					                               partner,
+					                               segment_id,
+					                               0,
+					                               size,
+					                               notification_id,
+					                               1,
+					                               q_id,
+					                               GASPI_BLOCK));
+				}
+				GASPI_CHECK(gaspi_notify_waitsome(
+				    segment_id, notification_id, 1, &first, GASPI_BLOCK));
+				GASPI_CHECK(gaspi_notify_reset(segment_id, first, &value));
+				if (!pairs_sender()) {
+					GASPI_CHECK(gaspi_write_notify(segment_id,
+					                               0,
+					                               partner,
+					                               segment_id,
+					                               0,
+					                               size,
+					                               notification_id,
+					                               1,
+					                               q_id,
+					                               GASPI_BLOCK));
+				}
+				if (pairs_sender() && i >= options.skip) {
+					record_round_trip(&measurements,
+					                  i - options.skip,
+					                  time,
+					                  stopwatch_stop(time));
+				}
+				GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+			}
+		}
+		print_pair_result(my_id, measurements, size);
+		free_gaspi_memory(segment_id);
+	}
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+#include <pthread.h>
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_memory.h"
+#include "util_placement.h"
+#include "util_sweep.h"
+
+/*
+ * Message rate of 1, 2, 4, ... threads on rank 0 posting to rank 1 at once.
+ * Every thread is pinned to its own core and writes a window to its own part
+ * of the segment through queue t % queues, an iteration ends when all
+ * threads have waited for their queue. Built as gbs_write_mt and, with
+ * WRITE_NOTIFY, as gbs_write_notify_mt.
+ */
+struct run_t {
+	pthread_barrier_t start;
+	pthread_barrier_t done;
+	int active; // cleared by thread 0 to let the others return
+	int threads;
+	int queues;
+	size_t size;
+};
+
+static const gaspi_segment_id_t segment_id = 0;
+static struct run_t run;
+
+static void post(const int t, const gaspi_offset_t offset) {
+	const gaspi_queue_id_t q_id = t % run.queues;
+	gaspi_return_t ret;
+
+	// queues shared by several threads can fill up within a window
+	while (1) {
+#ifdef WRITE_NOTIFY
+		ret = gaspi_write_notify(segment_id,
+		                         offset,
+		                         1,
+		                         segment_id,
+		                         offset,
+		                         run.size,
+		                         t,
+		                         1,
+		                         q_id,
+		                         GASPI_BLOCK);
+#else
+		ret = gaspi_write(segment_id,
+		                  offset,
+		                  1,
+		                  segment_id,
+		                  offset,
+		                  run.size,
+		                  q_id,
+		                  GASPI_BLOCK);
+#endif
+		if (ret != GASPI_QUEUE_FULL) {
+			break;
+		}
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	}
+	GASPI_CHECK(ret);
+}
+
+static void post_window(const int t) {
+	const gaspi_offset_t first = (gaspi_offset_t) t * options.window_size;
+	int j;
+
+	for (j = 0; j < options.window_size; ++j) {
+		post(t, (first + j) * run.size);
+	}
+	GASPI_CHECK(gaspi_wait(t % run.queues, GASPI_BLOCK));
+}
+
+static void* worker(void* arg) {
+	const int t = (int) (size_t) arg;
+
+	placement_pin_thread(t);
+	while (1) {
+		pthread_barrier_wait(&run.start);
+		if (!run.active) {
+			return NULL;
+		}
+		post_window(t);
+		pthread_barrier_wait(&run.done);
+	}
+}
+
+// thread 0 is the calling thread, pinned to the first core of the rank
+// while it measures, it starts and stops the timer
+static void measure(struct measurements_t* measurements) {
+	pthread_t threads[run.threads];
+	double time;
+	int i, t;
+
+	pthread_barrier_init(&run.start, NULL, run.threads);
+	pthread_barrier_init(&run.done, NULL, run.threads);
+	run.active = 1;
+	placement_pin_thread(0);
+	for (t = 1; t < run.threads; ++t) {
+		pthread_create(&threads[t], NULL, worker, (void*) (size_t) t);
+	}
+	for (i = 0; measure_continue(measurements, i, MEASURE_LOCAL); ++i) {
+		if (i >= options.skip) {
+			time = stopwatch_start();
+		}
+		pthread_barrier_wait(&run.start);
+		post_window(0);
+		pthread_barrier_wait(&run.done);
+		if (i >= options.skip) {
+			record_measurement(
+			    measurements, i - options.skip, time, stopwatch_stop(time));
+		}
+	}
+	run.active = 0;
+	pthread_barrier_wait(&run.start);
+	for (t = 1; t < run.threads; ++t) {
+		pthread_join(threads[t], NULL);
+	}
+	pthread_barrier_destroy(&run.start);
+	pthread_barrier_destroy(&run.done);
+	placement_unpin_thread();
+}
+
+static int queue_count(const int threads) {
+	if (options.queues == 0 || options.queues > threads) {
+		return threads;
+	}
+	return options.queues;
+}
+
+// creates queues until queue_count(options.threads) exist
+static void create_queues(void) {
+	const gaspi_number_t needed = queue_count(options.threads);
+	gaspi_number_t queue_num, queue_max;
+	gaspi_queue_id_t q_id;
+
+	GASPI_CHECK(gaspi_queue_num(&queue_num));
+	GASPI_CHECK(gaspi_queue_max(&queue_max));
+	if (needed > queue_max) {
+		fprintf(stderr,
+		        "%u queues requested, the implementation provides %u, "
+		        "use --queues to share them\n",
+		        needed,
+		        queue_max);
+		exit(EXIT_FAILURE);
+	}
+	for (; queue_num < needed; ++queue_num) {
+		GASPI_CHECK(gaspi_queue_create(&q_id, GASPI_BLOCK));
+	}
+}
+
+// 1, 2, 4, ... threads and the maximum, 0 after the last one
+static int next_thread_count(const int n) {
+	if (n == options.threads) {
+		return 0;
+	}
+	return 2 * n < options.threads ? 2 * n : options.threads;
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, num_pes;
+	size_t size;
+	int bo_ret = OPTIONS_OKAY;
+	int threads;
+	struct measurements_t measurements;
+
+	options.type = THREADED;
+	options.subtype = BW;
+#ifdef WRITE_NOTIFY
+	options.name = "gbs_write_notify_mt";
+#else
+	options.name = "gbs_write_mt";
+#endif
+
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	if (num_pes != 2) {
+		fprintf(stderr, "Benchmark requires exactly two processes!\n");
+		return EXIT_FAILURE;
+	}
+
+	init_measurements(&measurements);
+	create_queues();
+
+	print_header(my_id);
+
+	reserve_gaspi_memory(segment_id,
+	                     options.max_message_size * sweep_max_window() *
+	                         options.threads * sizeof(char));
+	for (threads = 1; threads != 0; threads = next_thread_count(threads)) {
+		run.threads = threads;
+		run.queues = queue_count(threads);
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			allocate_gaspi_memory(
+			    segment_id,
+			    size * options.window_size * threads * sizeof(char),
+			    my_id == 0 ? 'a' : 'b');
+			if (my_id == 0) {
+				run.size = size;
+				measure(&measurements);
+			}
+			print_threaded_result(
+			    my_id, measurements, size, threads, run.queues);
+			free_gaspi_memory(segment_id);
+		}
+	}
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
@@ -1,10 +1,12 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
+	gaspi_number_t notification_num;
 	int i;
 	int bo_ret = OPTIONS_OKAY;
 	double time;
@@ -34,41 +36,49 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	GASPI_CHECK(gaspi_notification_num(&notification_num));
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id = 0;
 	const gaspi_queue_id_t q_id = 0;
 	gaspi_notification_t notification_val = 1;
 	gaspi_notification_id_t notification_id = 0;
+	gaspi_notification_id_t id;
+	gaspi_notification_t value;
 
 	print_header(my_id);
 
 	allocate_gaspi_memory(segment_id, sizeof(char), 'a');
-	for (i = 0; i < options.iterations + options.skip; ++i) {
+	for (i = 0; measure_continue(&measurements, i, MEASURE_COLLECTIVE); ++i) {
+		// adaptive runs may outlast the ids, a reused id is reset below
+		id = i % notification_num;
 		if (my_id == 0) {
 			if (i >= options.skip) {
 				time = stopwatch_start();
 			}
 			GASPI_CHECK(gaspi_notify(
-			    segment_id, 1, i, notification_val, q_id, GASPI_BLOCK));
+			    segment_id, 1, id, notification_val, q_id, GASPI_BLOCK));
 			GASPI_CHECK(gaspi_notify_waitsome(
-			    segment_id, i, 1, &notification_id, GASPI_BLOCK));
+			    segment_id, id, 1, &notification_id, GASPI_BLOCK));
 			if (i >= options.skip) {
-				measurements.time[i - options.skip] = stopwatch_stop(time);
+				record_measurement(&measurements,
+				                   i - options.skip,
+				                   time,
+				                   stopwatch_stop(time));
 			}
 		}
 		else {
 			GASPI_CHECK(gaspi_notify_waitsome(
-			    segment_id, i, 1, &notification_id, GASPI_BLOCK));
+			    segment_id, id, 1, &notification_id, GASPI_BLOCK));
 			GASPI_CHECK(
-			    gaspi_notify(segment_id, 0, i, my_id, q_id, GASPI_BLOCK));
+			    gaspi_notify(segment_id, 0, id, my_id, q_id, GASPI_BLOCK));
 		}
+		GASPI_CHECK(gaspi_notify_reset(segment_id, id, &value));
 		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
 	}
 	print_notify_lat(my_id, measurements);
 	free_gaspi_memory(segment_id);
-	free(measurements.time);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
@@ -1,6 +1,7 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
 
 int main(int argc, char* argv[]) {
@@ -35,8 +36,7 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id = 0;
 	const gaspi_queue_id_t q_id = 0;
@@ -47,7 +47,7 @@ int main(int argc, char* argv[]) {
 	print_header(my_id);
 	window_size = options.window_size;
 	allocate_gaspi_memory(segment_id, sizeof(char), 'a');
-	for (i = 0; i < options.iterations + options.skip; ++i) {
+	for (i = 0; measure_continue(&measurements, i, MEASURE_COLLECTIVE); ++i) {
 		if (my_id == 0) {
 			if (i >= options.skip) {
 				time = stopwatch_start();
@@ -62,7 +62,10 @@ int main(int argc, char* argv[]) {
 			}
 			GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
 			if (i >= options.skip) {
-				measurements.time[i - options.skip] = stopwatch_stop(time);
+				record_measurement(&measurements,
+				                   i - options.skip,
+				                   time,
+				                   stopwatch_stop(time));
 			}
 		}
 		else {
@@ -72,7 +75,7 @@ int main(int argc, char* argv[]) {
 	}
 	print_notify_lat(my_id, measurements);
 	free_gaspi_memory(segment_id);
-	free(measurements.time);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,153 @@
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_memory.h"
+#include "util_offsets.h"
+#include "util_sweep.h"
+#include "util_verify.h"
+#include "util_wait.h"
+
+/*
+ * Ping-pong latency of gaspi_read. The ranks take turns: rank 0 reads the
+ * payload of rank 1 and passes the turn with a gaspi_notify once it has
+ * arrived, rank 1 then reads the payload of rank 0 and passes the turn back.
+ * A sample is half of the round trip as timed by rank 0, i.e. one read and
+ * the notification that hands over the turn.
+ */
+
+static const gaspi_segment_id_t segment_id = 0;
+static const gaspi_queue_id_t q_id = 0;
+static const gaspi_notification_id_t notification_id = 0;
+
+static void read_from(const gaspi_rank_t peer,
+                      const gaspi_offset_t offset,
+                      const size_t size) {
+	GASPI_CHECK(gaspi_read(
+	    segment_id, offset, peer, segment_id, offset, size, q_id, GASPI_BLOCK));
+	wait_queue(q_id);
+	GASPI_CHECK(
+	    gaspi_notify(segment_id, peer, notification_id, 1, q_id, GASPI_BLOCK));
+}
+
+// rank 1 provides a new pattern, rank 0 reads it into a cleared buffer
+static void prepare_verify(const gaspi_rank_t my_id,
+                           const size_t size,
+                           const int i) {
+	if (my_id == 1) {
+		verify_fill(segment_id, 0, size, verify_seed(1, size, i));
+	}
+	else {
+		verify_clear(segment_id, 0, size);
+	}
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+}
+
+static int measure(const gaspi_rank_t my_id,
+                   const size_t size,
+                   struct measurements_t* measurements) {
+	gaspi_offset_t offset;
+	double time;
+	int i;
+
+	for (i = 0; measure_continue(measurements, i, MEASURE_COLLECTIVE); ++i) {
+		if (verify_iteration(i)) {
+			prepare_verify(my_id, size, i);
+		}
+		// both ranks draw the same offsets
+		offset = offsets_next(size, 0);
+		if (my_id == 0) {
+			time = stopwatch_start();
+			read_from(1, offset, size);
+			wait_notify(segment_id, notification_id);
+			if (i >= options.skip) {
+				record_round_trip(measurements,
+				                  i - options.skip,
+				                  time,
+				                  stopwatch_stop(time));
+			}
+			wait_queue(q_id);
+			// rank 1 only reads the pattern back, the buffer stays unchanged
+			if (verify_iteration(i) &&
+			    !verify_check(segment_id, 0, size, verify_seed(1, size, i))) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return 0;
+			}
+		}
+		else {
+			wait_notify(segment_id, notification_id);
+			read_from(0, offset, size);
+			wait_queue(q_id);
+		}
+	}
+	return 1;
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, num_pes;
+	size_t size;
+	int bo_ret = OPTIONS_OKAY;
+	struct measurements_t measurements;
+
+	options.type = ONESIDED;
+	options.subtype = LAT;
+	options.name = "gbs_read_pingpong";
+
+	verify_every_enable();
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	if (num_pes != 2) {
+		fprintf(stderr, "Benchmark requires exactly two processes!\n");
+		return EXIT_FAILURE;
+	}
+
+	init_measurements(&measurements);
+
+	print_header(my_id);
+
+	if (options.single_buffer) {
+		allocate_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)),
+		    my_id == 0 ? 'a' : 'b');
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			if (!measure(my_id, size, &measurements)) {
+				return EXIT_FAILURE;
+			}
+			print_result(my_id, measurements, size);
+		}
+		free_gaspi_memory(segment_id);
+	}
+	else {
+		reserve_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			allocate_gaspi_memory(segment_id,
+			                      offsets_footprint(size * sizeof(char)),
+			                      my_id == 0 ? 'a' : 'b');
+			if (!measure(my_id, size, &measurements)) {
+				return EXIT_FAILURE;
+			}
+			print_result(my_id, measurements, size);
+			free_gaspi_memory(segment_id);
+		}
+	}
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
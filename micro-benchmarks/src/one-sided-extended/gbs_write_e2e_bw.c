@@ -0,0 +1,311 @@
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_delivery.h"
+#include "util_memory.h"
+#include "util_offsets.h"
+#include "util_sweep.h"
+#include "util_verify.h"
+
+/*
+ * End-to-end bandwidth of gaspi_write: the clock stops once rank 1 has
+ * acknowledged the arrival of the whole window instead of at the local
+ * completion of the queue. By default only the last write of a window
+ * notifies rank 1, GASPI makes a notification visible only after the writes
+ * posted before it to the same queue and rank. Built with E2E_PER_MESSAGE
+ * every write notifies and rank 1 waits for all of them. Rank 1 answers with
+ * a gaspi_notify to rank 0.
+ *
+ * With --delivery poll the writes carry no notification: the last byte of
+ * every notifying message holds a token rank 1 spins on, and rank 1 writes
+ * a token back into the last byte of the window on rank 0.
+ */
+
+#ifdef E2E_PER_MESSAGE
+#define E2E_NAME "gbs_write_e2e_msg_bw"
+#else
+#define E2E_NAME "gbs_write_e2e_bw"
+#endif
+
+static const gaspi_segment_id_t segment_id = 0;
+static const gaspi_queue_id_t q_id = 0;
+static const gaspi_notification_id_t ack_id = 0;
+
+// notifications rank 1 waits for per window
+static int notifications(const int window_size) {
+#ifdef E2E_PER_MESSAGE
+	return window_size;
+#else
+	return 1;
+#endif
+}
+
+static gaspi_notification_id_t notification_id(const int j) {
+#ifdef E2E_PER_MESSAGE
+	return j;
+#else
+	return 0;
+#endif
+}
+
+// whether message j of a window tells rank 1 about its arrival
+static int notifies(const int j, const int window_size) {
+#ifdef E2E_PER_MESSAGE
+	return 1;
+#else
+	return j + 1 == window_size;
+#endif
+}
+
+static gaspi_offset_t message_offset(const size_t size, const int j) {
+	return offsets_next(size, options.single_buffer ? 0 : j * size);
+}
+
+static void write_to(const gaspi_rank_t peer,
+                     const gaspi_offset_t offset,
+                     const size_t size) {
+	GASPI_CHECK(gaspi_write(
+	    segment_id, offset, peer, segment_id, offset, size, q_id, GASPI_BLOCK));
+}
+
+// returns the offset of the last message
+static gaspi_offset_t send_window(const size_t size, const int window_size) {
+	gaspi_offset_t offset = 0;
+	int j;
+
+	for (j = 0; j < window_size; ++j) {
+		offset = message_offset(size, j);
+		if (!notifies(j, window_size)) {
+			write_to(1, offset, size);
+		}
+		else if (delivery_mode() == DELIVERY_POLL) {
+			delivery_mark(segment_id, offset + size - 1, DELIVERY_PING);
+			write_to(1, offset, size);
+		}
+		else {
+			GASPI_CHECK(gaspi_write_notify(segment_id,
+			                               offset,
+			                               1,
+			                               segment_id,
+			                               offset,
+			                               size,
+			                               notification_id(j),
+			                               1,
+			                               q_id,
+			                               GASPI_BLOCK));
+		}
+	}
+	return offset;
+}
+
+// waits for count notifications among the first count ids
+static void wait_notifications(const int count) {
+	gaspi_notification_id_t first;
+	gaspi_notification_t value;
+	int arrived = 0;
+
+	while (arrived < count) {
+		GASPI_CHECK(gaspi_notify_waitsome(
+		    segment_id, 0, count, &first, GASPI_BLOCK));
+		GASPI_CHECK(gaspi_notify_reset(segment_id, first, &value));
+		if (value != 0) {
+			++arrived;
+		}
+	}
+}
+
+// returns the offset of the last message, rank 1 draws the same offsets
+static gaspi_offset_t receive_window(const size_t size,
+                                     const int window_size) {
+	gaspi_offset_t offset = 0;
+	int j;
+
+	for (j = 0; j < window_size; ++j) {
+		offset = message_offset(size, j);
+		if (delivery_mode() == DELIVERY_POLL && notifies(j, window_size)) {
+			delivery_poll(segment_id, offset + size - 1, DELIVERY_PING);
+			delivery_mark(segment_id, offset + size - 1, 0);
+		}
+	}
+	if (delivery_mode() == DELIVERY_NOTIFY) {
+		wait_notifications(notifications(window_size));
+	}
+	return offset;
+}
+
+// with polling the last byte of the last message goes back as the token
+static void acknowledge(const gaspi_offset_t last, const size_t size) {
+	if (delivery_mode() == DELIVERY_POLL) {
+		delivery_mark(segment_id, last + size - 1, DELIVERY_PONG);
+		write_to(0, last + size - 1, 1);
+	}
+	else {
+		GASPI_CHECK(gaspi_notify(segment_id, 0, ack_id, 1, q_id, GASPI_BLOCK));
+	}
+}
+
+static void wait_acknowledgement(const gaspi_offset_t last, const size_t size) {
+	if (delivery_mode() == DELIVERY_POLL) {
+		delivery_poll(segment_id, last + size - 1, DELIVERY_PONG);
+	}
+	else {
+		wait_notifications(1);
+	}
+}
+
+// the tokens replace the last byte of the notifying messages
+static int verify_payload(const size_t size,
+                          const int window_size,
+                          const int i) {
+	const uint64_t seed = verify_seed(0, size, i);
+	int j;
+
+	if (delivery_mode() == DELIVERY_NOTIFY) {
+		return verify_check(segment_id,
+		                    0,
+		                    options.single_buffer ? size : size * window_size,
+		                    seed);
+	}
+	for (j = 0; j < window_size; ++j) {
+		if (!verify_check(segment_id,
+		                  j * size,
+		                  notifies(j, window_size) ? size - 1 : size,
+		                  seed)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static int measure(const gaspi_rank_t my_id,
+                   const size_t size,
+                   struct measurements_t* measurements) {
+	const int window_size = options.window_size;
+	const size_t bytes = options.single_buffer ? size : size * window_size;
+	const int poll = delivery_mode() == DELIVERY_POLL;
+	gaspi_offset_t last;
+	double time;
+	int i, unordered = 0;
+
+	for (i = 0; measure_continue(measurements, i, MEASURE_COLLECTIVE); ++i) {
+		if (my_id == 0) {
+			if (verify_iteration(i)) {
+				verify_fill(segment_id, 0, bytes, verify_seed(my_id, size, i));
+			}
+			time = stopwatch_start();
+			last = send_window(size, window_size);
+			wait_acknowledgement(last, size);
+			if (i >= options.skip) {
+				record_measurement(
+				    measurements, i - options.skip, time, stopwatch_stop(time));
+			}
+			GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+			if (poll) {
+				delivery_mark(segment_id, last + size - 1, 0);
+			}
+		}
+		else {
+			last = receive_window(size, window_size);
+			// the rest of the window must be there together with the tokens
+			if (poll && verify_iteration(i) &&
+			    !verify_payload(size, window_size, i)) {
+				++unordered;
+			}
+			acknowledge(last, size);
+			GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+			if (!poll && verify_iteration(i) &&
+			    !verify_payload(size, window_size, i)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return 0;
+			}
+		}
+		// the next window must not overwrite the payload being checked
+		if (verify_iteration(i)) {
+			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+		}
+	}
+	return !poll || delivery_ordered(unordered);
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, num_pes;
+	gaspi_number_t notification_num;
+	size_t size;
+	int bo_ret = OPTIONS_OKAY;
+	struct measurements_t measurements;
+
+	options.type = ONESIDED;
+	options.subtype = BW;
+	options.name = E2E_NAME;
+
+	delivery_enable();
+	verify_every_enable();
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	if (num_pes != 2) {
+		fprintf(stderr, "Benchmark requires exactly two processes!\n");
+		return EXIT_FAILURE;
+	}
+	if (options.single_buffer && delivery_polls()) {
+		fprintf(stderr, "Polling needs a buffer per message, not -b!\n");
+		return EXIT_FAILURE;
+	}
+	GASPI_CHECK(gaspi_notification_num(&notification_num));
+	if ((gaspi_number_t) notifications(sweep_max_window()) > notification_num) {
+		fprintf(stderr, "Window size exceeds the number of notifications!\n");
+		return EXIT_FAILURE;
+	}
+
+	init_measurements(&measurements);
+
+	print_header(my_id);
+
+	if (options.single_buffer) {
+		allocate_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)),
+		    my_id == 0 ? 'a' : 'b');
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			if (!measure(my_id, size, &measurements)) {
+				return EXIT_FAILURE;
+			}
+			print_result(my_id, measurements, size);
+		}
+		free_gaspi_memory(segment_id);
+	}
+	else {
+		reserve_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sweep_max_window() *
+		                      sizeof(char)));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			allocate_gaspi_memory(
+			    segment_id,
+			    offsets_footprint(size * options.window_size * sizeof(char)),
+			    my_id == 0 ? 'a' : 'b');
+			if (!measure(my_id, size, &measurements)) {
+				return EXIT_FAILURE;
+			}
+			print_result(my_id, measurements, size);
+			free_gaspi_memory(segment_id);
+		}
+	}
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
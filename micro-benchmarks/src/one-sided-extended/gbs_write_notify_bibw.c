@@ -1,7 +1,10 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_sweep.h"
+#include "util_verify.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
@@ -9,7 +12,6 @@ int main(int argc, char* argv[]) {
 	int i, j;
 	int bo_ret = OPTIONS_OKAY;
 	double time;
-	char check_val;
 	struct measurements_t measurements;
 
 	options.type = ONESIDED;
@@ -36,8 +38,7 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id_send = 0;
 	const gaspi_segment_id_t segment_id_recv = 1;
@@ -46,8 +47,6 @@ int main(int argc, char* argv[]) {
 	const gaspi_notification_id_t notification_id = 0;
 	gaspi_notification_id_t first;
 
-	gaspi_pointer_t ptr;
-
 	print_header(my_id);
 
 	int window_size = options.window_size;
@@ -57,12 +56,20 @@ int main(int argc, char* argv[]) {
 		                      my_id == 0 ? 'a' : 'b');
 		allocate_gaspi_memory(
 		    segment_id_recv, options.max_message_size * sizeof(char), 'y');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id_recv, &ptr));
 		GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
+			if (options.verify) {
+				// both ranks send their own pattern
+				verify_fill(
+				    segment_id_send, 0, size, verify_seed(my_id, size, 0));
+				verify_clear(segment_id_recv, 0, size);
+				GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+			}
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
 					GASPI_CHECK(gaspi_barrier(q_id, GASPI_BLOCK));
 					if (i >= options.skip) {
 						time = stopwatch_start();
@@ -86,13 +93,17 @@ int main(int argc, char* argv[]) {
 					                                  &first,
 					                                  GASPI_BLOCK));
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
 				}
 			}
 			else if (my_id == 1) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
 					GASPI_CHECK(gaspi_barrier(q_id, GASPI_BLOCK));
 					for (j = 0; j < window_size; ++j) {
 						GASPI_CHECK(gaspi_write_notify(segment_id_send,
@@ -115,15 +126,13 @@ int main(int argc, char* argv[]) {
 				}
 			}
 			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			if (options.verify) {
-				check_val = my_id == 0 ? 'b' : 'a';
-				for (i = 0; i < size * window_size; ++i) {
-					if (((char*) ptr)[i] != check_val) {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_check(segment_id_recv,
+			                  0,
+			                  size,
+			                  verify_seed(1 - my_id, size, 0))) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 			print_result(my_id, measurements, size * 2);
 		}
@@ -131,18 +140,32 @@ int main(int argc, char* argv[]) {
 		free_gaspi_memory(segment_id_recv);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		reserve_gaspi_memory(
+		    segment_id_send,
+		    options.max_message_size * sweep_max_window() * sizeof(char));
+		reserve_gaspi_memory(
+		    segment_id_recv,
+		    options.max_message_size * sweep_max_window() * sizeof(char));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
 			allocate_gaspi_memory(segment_id_send,
 			                      size * window_size * sizeof(char),
 			                      my_id == 0 ? 'a' : 'b');
 			allocate_gaspi_memory(
 			    segment_id_recv, size * window_size * sizeof(char), 'y');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id_recv, &ptr));
+			if (options.verify) {
+				verify_fill(segment_id_send,
+				            0,
+				            size * window_size,
+				            verify_seed(my_id, size, 0));
+				verify_clear(segment_id_recv, 0, size * window_size);
+			}
 			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
 
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
 					GASPI_CHECK(gaspi_barrier(q_id, GASPI_BLOCK));
 					if (i >= options.skip) {
 						time = stopwatch_start();
@@ -166,13 +189,17 @@ int main(int argc, char* argv[]) {
 					                                  &first,
 					                                  GASPI_BLOCK));
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
 				}
 			}
 			else if (my_id == 1) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
 					GASPI_CHECK(gaspi_barrier(q_id, GASPI_BLOCK));
 					for (j = 0; j < window_size; ++j) {
 						GASPI_CHECK(gaspi_write_notify(segment_id_send,
@@ -195,22 +222,21 @@ int main(int argc, char* argv[]) {
 				}
 			}
 			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			if (options.verify) {
-				check_val = my_id == 0 ? 'b' : 'a';
-				for (i = 0; i < size * window_size; ++i) {
-					if (((char*) ptr)[i] != check_val) {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_check(segment_id_recv,
+			                  0,
+			                  size * window_size,
+			                  verify_seed(1 - my_id, size, 0))) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 			print_result(my_id, measurements, size * 2);
 			free_gaspi_memory(segment_id_send);
 			free_gaspi_memory(segment_id_recv);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
@@ -1,7 +1,10 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_sweep.h"
+#include "util_verify.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
@@ -35,14 +38,12 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id = 0;
 	const gaspi_queue_id_t q_id = 0;
 	const gaspi_notification_t notification_val = 1;
 	const gaspi_notification_id_t notification_id = 0;
-	gaspi_pointer_t ptr;
 
 	print_header(my_id);
 
@@ -51,11 +52,15 @@ int main(int argc, char* argv[]) {
 		allocate_gaspi_memory(segment_id,
 		                      options.max_message_size * sizeof(char),
 		                      my_id == 0 ? 'a' : 'b');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
+			if (options.verify) {
+				verify_prepare(segment_id, size, 0, size);
+			}
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
@@ -73,35 +78,38 @@ int main(int argc, char* argv[]) {
 					}
 					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
 				}
 			}
-			if (my_id == 1 && options.verify) {
-				GASPI_CHECK(
-				    gaspi_notify_waitsome(segment_id, 0, 1, 0, GASPI_BLOCK));
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_received(segment_id, size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 			print_result(my_id, measurements, size);
 		}
 		free_gaspi_memory(segment_id);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		reserve_gaspi_memory(
+		    segment_id,
+		    options.max_message_size * sweep_max_window() * sizeof(char));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
 			allocate_gaspi_memory(segment_id,
 			                      size * window_size * sizeof(char),
 			                      my_id == 0 ? 'a' : 'b');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+			if (options.verify) {
+				verify_prepare(segment_id, size * window_size, 0, size);
+			}
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
@@ -119,31 +127,25 @@ int main(int argc, char* argv[]) {
 					}
 					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
 				}
 			}
-			if (options.verify) {
-				GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			}
-			if (my_id == 1 && options.verify) {
-				gaspi_notification_id_t id_t;
-				GASPI_CHECK(gaspi_notify_waitsome(segment_id,0,1,&id_t,GASPI_BLOCK));
-				for (i = 0; i < size * window_size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid! @index %d %c\n",i,((char*)ptr)[i]);
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_received(segment_id, size * window_size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 
 			print_result(my_id, measurements, size);
 			free_gaspi_memory(segment_id);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
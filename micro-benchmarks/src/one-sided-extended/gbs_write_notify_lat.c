@@ -1,7 +1,11 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_sweep.h"
+#include "util_verify.h"
+#include "util_wait.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
@@ -35,14 +39,12 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id = 0;
 	const gaspi_queue_id_t q_id = 0;
 	const gaspi_notification_t notification_val = 1;
 	const gaspi_notification_id_t notification_id = 0;
-	gaspi_pointer_t ptr;
 
 	print_header(my_id);
 
@@ -50,11 +52,14 @@ int main(int argc, char* argv[]) {
 		allocate_gaspi_memory(segment_id,
 		                      options.max_message_size * sizeof(char),
 		                      my_id == 0 ? 'a' : 'b');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			if (options.verify) {
+				verify_prepare(segment_id, size, 0, size);
+			}
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
@@ -68,37 +73,37 @@ int main(int argc, char* argv[]) {
 					                               notification_val,
 					                               q_id,
 					                               GASPI_BLOCK));
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+					wait_queue(q_id);
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
 				}
 			}
-			if (options.verify) {
-				GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			}
-			if (my_id == 1 && options.verify) {
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_received(segment_id, size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 			print_result(my_id, measurements, size);
 		}
 		free_gaspi_memory(segment_id);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		reserve_gaspi_memory(segment_id,
+		                     options.max_message_size * sizeof(char));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
 			allocate_gaspi_memory(
 			    segment_id, size * sizeof(char), my_id == 0 ? 'a' : 'b');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+			if (options.verify) {
+				verify_prepare(segment_id, size, 0, size);
+			}
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
@@ -112,30 +117,26 @@ int main(int argc, char* argv[]) {
 					                               notification_val,
 					                               q_id,
 					                               GASPI_BLOCK));
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+					wait_queue(q_id);
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
 				}
 			}
-			if (options.verify) {
-				GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			}
-			if (my_id == 1 && options.verify) {
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_received(segment_id, size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 			print_result(my_id, measurements, size);
 			free_gaspi_memory(segment_id);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
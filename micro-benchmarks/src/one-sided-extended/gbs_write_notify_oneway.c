@@ -0,0 +1,244 @@
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_clocksync.h"
+#include "util_memory.h"
+#include "util_sweep.h"
+#include "util_verify.h"
+
+/*
+ * One-way latency of gaspi_write_notify in both directions. Rank 0 writes to
+ * rank 1, which writes back as soon as the notification arrived. Send and
+ * arrival are timestamped on the rank where they happen and compared on the
+ * clock of rank 0. The loop itself is timed as a round trip, which is what
+ * --adaptive and --raw-file see. The clock model takes one more window after
+ * every message size, so it covers the timestamps it converts.
+ */
+
+static const gaspi_segment_id_t segment_id = 0;
+static const gaspi_segment_id_t stamp_segment_id = 1;
+static const gaspi_queue_id_t q_id = 0;
+
+static void wait_notification(const gaspi_segment_id_t segment,
+                              const gaspi_notification_id_t id) {
+	gaspi_notification_id_t first;
+	gaspi_notification_t value;
+
+	GASPI_CHECK(gaspi_notify_waitsome(segment, id, 1, &first, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_notify_reset(segment, first, &value));
+}
+
+static void write_to(const gaspi_rank_t peer,
+                     const size_t size,
+                     const gaspi_notification_id_t id) {
+	GASPI_CHECK(gaspi_write_notify(
+	    segment_id, 0, peer, segment_id, 0, size, id, 1, q_id, GASPI_BLOCK));
+}
+
+/*
+ * Rank 0 keeps its send and return timestamps, rank 1 its arrival and
+ * departure timestamps in the stamp segment. Returns the number of timed
+ * iterations.
+ */
+static int pingpong(const gaspi_rank_t my_id,
+                    const size_t size,
+                    const int capacity,
+                    struct measurements_t* roundtrip,
+                    double* send,
+                    double* back) {
+	gaspi_pointer_t ptr;
+	double* stamps;
+	double time, rtt, departure;
+	int i;
+
+	GASPI_CHECK(gaspi_segment_ptr(stamp_segment_id, &ptr));
+	stamps = ptr;
+	for (i = 0; measure_continue(roundtrip, i, MEASURE_COLLECTIVE); ++i) {
+		if (my_id == 0) {
+			time = stopwatch_start();
+			write_to(1, size, 0);
+			wait_notification(segment_id, 1);
+			rtt = stopwatch_stop(time);
+			GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+			if (i >= options.skip) {
+				send[i - options.skip] = time;
+				back[i - options.skip] = time + rtt;
+				record_measurement(roundtrip, i - options.skip, time, rtt);
+			}
+		}
+		else {
+			wait_notification(segment_id, 0);
+			time = stopwatch_start();
+			departure = stopwatch_start();
+			write_to(0, size, 1);
+			GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+			if (i >= options.skip) {
+				stamps[i - options.skip] = time;
+				stamps[capacity + i - options.skip] = departure;
+			}
+		}
+	}
+	return i - options.skip;
+}
+
+// moves the timestamps of rank 1 to rank 0 and computes both directions
+static void one_way(const gaspi_rank_t my_id,
+                    const int capacity,
+                    const int recorded,
+                    const struct measurements_t* roundtrip,
+                    const double* send,
+                    const double* back,
+                    struct measurements_t* forward,
+                    struct measurements_t* backward) {
+	gaspi_pointer_t ptr;
+	double* stamps;
+	int first, k;
+
+	GASPI_CHECK(gaspi_segment_ptr(stamp_segment_id, &ptr));
+	stamps = ptr;
+	if (my_id == 1) {
+		for (k = 0; k < recorded; ++k) {
+			stamps[k] = clocksync_global(stamps[k]);
+			stamps[capacity + k] = clocksync_global(stamps[capacity + k]);
+		}
+		GASPI_CHECK(gaspi_write_notify(stamp_segment_id,
+		                               0,
+		                               0,
+		                               stamp_segment_id,
+		                               0,
+		                               2 * capacity * sizeof(double),
+		                               0,
+		                               1,
+		                               q_id,
+		                               GASPI_BLOCK));
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+		return;
+	}
+	wait_notification(stamp_segment_id, 0);
+	// --adaptive may have dropped the first samples as warm-up
+	first = recorded - roundtrip->n;
+	for (k = 0; k < roundtrip->n; ++k) {
+		forward->time[k] =
+		    stamps[first + k] - clocksync_global(send[first + k]);
+		backward->time[k] = clocksync_global(back[first + k]) -
+		                    stamps[capacity + first + k];
+	}
+	forward->n = roundtrip->n;
+	backward->n = roundtrip->n;
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, num_pes;
+	size_t size;
+	int capacity, recorded;
+	int bo_ret = OPTIONS_OKAY;
+	double *send, *back;
+	struct measurements_t roundtrip, forward, backward;
+
+	options.type = ONESIDED;
+	options.subtype = ONEWAY;
+	options.name = "gbs_write_notify_oneway";
+
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	if (num_pes != 2) {
+		fprintf(stderr, "Benchmark requires exactly two processes!\n");
+		return EXIT_FAILURE;
+	}
+
+	clocksync_init();
+	init_measurements(&roundtrip);
+	capacity = options.adaptive ? options.max_iterations : options.iterations;
+	send = malloc(capacity * sizeof(double));
+	back = malloc(capacity * sizeof(double));
+	forward.time = malloc(capacity * sizeof(double));
+	forward.stream = NULL;
+	backward.time = malloc(capacity * sizeof(double));
+	backward.stream = NULL;
+	allocate_gaspi_memory(stamp_segment_id, 2 * capacity * sizeof(double), 0);
+
+	print_header(my_id);
+
+	if (options.single_buffer) {
+		allocate_gaspi_memory(segment_id,
+		                      options.max_message_size * sizeof(char),
+		                      my_id == 0 ? 'a' : 'b');
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			if (options.verify) {
+				verify_prepare(segment_id, size, 0, size);
+			}
+			recorded =
+			    pingpong(my_id, size, capacity, &roundtrip, send, back);
+			clocksync_update();
+			one_way(my_id,
+			        capacity,
+			        recorded,
+			        &roundtrip,
+			        send,
+			        back,
+			        &forward,
+			        &backward);
+			if (options.verify &&
+			    !verify_received(segment_id, size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
+			}
+			print_oneway_result(
+			    my_id, forward, backward, size, clocksync_error());
+		}
+		free_gaspi_memory(segment_id);
+	}
+	else {
+		reserve_gaspi_memory(segment_id,
+		                     options.max_message_size * sizeof(char));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			allocate_gaspi_memory(
+			    segment_id, size * sizeof(char), my_id == 0 ? 'a' : 'b');
+			if (options.verify) {
+				verify_prepare(segment_id, size, 0, size);
+			}
+			recorded =
+			    pingpong(my_id, size, capacity, &roundtrip, send, back);
+			clocksync_update();
+			one_way(my_id,
+			        capacity,
+			        recorded,
+			        &roundtrip,
+			        send,
+			        back,
+			        &forward,
+			        &backward);
+			if (options.verify &&
+			    !verify_received(segment_id, size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
+			}
+			print_oneway_result(
+			    my_id, forward, backward, size, clocksync_error());
+			free_gaspi_memory(segment_id);
+		}
+	}
+	free_gaspi_memory(stamp_segment_id);
+	free(forward.time);
+	free(backward.time);
+	free(send);
+	free(back);
+	print_registration(my_id);
+	free_measurements(&roundtrip);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_delivery.h"
+#include "util_memory.h"
+#include "util_offsets.h"
+#include "util_sweep.h"
+#include "util_verify.h"
+#include "util_wait.h"
+
+/*
+ * Ping-pong latency of gaspi_write_notify. Rank 0 writes the payload to
+ * rank 1, which writes it back as soon as the notification arrived. A sample
+ * is half of the round trip as timed by rank 0. With --delivery poll the
+ * payload goes with a plain gaspi_write and its last byte carries the token
+ * the receiver spins on.
+ */
+
+static const gaspi_segment_id_t segment_id = 0;
+static const gaspi_queue_id_t q_id = 0;
+static const gaspi_notification_id_t notification_id = 0;
+
+static void write_to(const gaspi_rank_t peer,
+                     const gaspi_offset_t offset,
+                     const size_t size) {
+	if (delivery_mode() == DELIVERY_POLL) {
+		GASPI_CHECK(gaspi_write(segment_id,
+		                        offset,
+		                        peer,
+		                        segment_id,
+		                        offset,
+		                        size,
+		                        q_id,
+		                        GASPI_BLOCK));
+		return;
+	}
+	GASPI_CHECK(gaspi_write_notify(segment_id,
+	                               offset,
+	                               peer,
+	                               segment_id,
+	                               offset,
+	                               size,
+	                               notification_id,
+	                               1,
+	                               q_id,
+	                               GASPI_BLOCK));
+}
+
+static void arrive(const gaspi_offset_t offset,
+                   const size_t size,
+                   const unsigned char token) {
+	if (delivery_mode() == DELIVERY_POLL) {
+		delivery_poll(segment_id, offset + size - 1, token);
+	}
+	else {
+		wait_notify(segment_id, notification_id);
+	}
+}
+
+// the token replaces the last byte of the pattern
+static size_t pattern_size(const size_t size) {
+	return delivery_mode() == DELIVERY_POLL ? size - 1 : size;
+}
+
+// rank 0 sends a new pattern, rank 1 receives it into a cleared buffer
+static void prepare_verify(const gaspi_rank_t my_id,
+                           const size_t size,
+                           const int i) {
+	if (my_id == 0) {
+		verify_fill(segment_id, 0, size, verify_seed(0, size, i));
+	}
+	else {
+		verify_clear(segment_id, 0, size);
+	}
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+}
+
+static int verify_payload(const size_t size, const int i) {
+	return verify_check(
+	    segment_id, 0, pattern_size(size), verify_seed(0, size, i));
+}
+
+static int measure(const gaspi_rank_t my_id,
+                   const size_t size,
+                   struct measurements_t* measurements) {
+	const int poll = delivery_mode() == DELIVERY_POLL;
+	gaspi_offset_t offset;
+	double time;
+	int i, unordered = 0;
+
+	for (i = 0; measure_continue(measurements, i, MEASURE_COLLECTIVE); ++i) {
+		if (verify_iteration(i)) {
+			prepare_verify(my_id, size, i);
+		}
+		// both ranks draw the same offsets
+		offset = offsets_next(size, 0);
+		if (my_id == 0) {
+			if (poll) {
+				delivery_mark(segment_id, offset + size - 1, DELIVERY_PING);
+			}
+			time = stopwatch_start();
+			write_to(1, offset, size);
+			arrive(offset, size, DELIVERY_PONG);
+			if (i >= options.skip) {
+				record_round_trip(measurements,
+				                  i - options.skip,
+				                  time,
+				                  stopwatch_stop(time));
+			}
+			wait_queue(q_id);
+			if (poll) {
+				delivery_mark(segment_id, offset + size - 1, 0);
+			}
+		}
+		else {
+			arrive(offset, size, DELIVERY_PING);
+			// the rest of the payload must be there together with the token
+			if (poll && verify_iteration(i) && !verify_payload(size, i)) {
+				++unordered;
+			}
+			if (poll) {
+				delivery_mark(segment_id, offset + size - 1, DELIVERY_PONG);
+			}
+			// the token stays, rank 0 may already send the next one
+			write_to(0, offset, size);
+			wait_queue(q_id);
+			// only a verified iteration writes a new pattern
+			if (!poll && verify_iteration(i) && !verify_payload(size, i)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return 0;
+			}
+		}
+	}
+	return !poll || delivery_ordered(unordered);
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, num_pes;
+	size_t size;
+	int bo_ret = OPTIONS_OKAY;
+	struct measurements_t measurements;
+
+	options.type = ONESIDED;
+	options.subtype = LAT;
+	options.name = "gbs_write_notify_pingpong";
+
+	delivery_enable();
+	verify_every_enable();
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	if (num_pes != 2) {
+		fprintf(stderr, "Benchmark requires exactly two processes!\n");
+		return EXIT_FAILURE;
+	}
+
+	init_measurements(&measurements);
+
+	print_header(my_id);
+
+	if (options.single_buffer) {
+		allocate_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)),
+		    my_id == 0 ? 'a' : 'b');
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			if (!measure(my_id, size, &measurements)) {
+				return EXIT_FAILURE;
+			}
+			print_result(my_id, measurements, size);
+		}
+		free_gaspi_memory(segment_id);
+	}
+	else {
+		reserve_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			allocate_gaspi_memory(segment_id,
+			                      offsets_footprint(size * sizeof(char)),
+			                      my_id == 0 ? 'a' : 'b');
+			if (!measure(my_id, size, &measurements)) {
+				return EXIT_FAILURE;
+			}
+			print_result(my_id, measurements, size);
+			free_gaspi_memory(segment_id);
+		}
+	}
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
@@ -1,12 +1,14 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_verify.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
 	size_t size;
-	int i;
+	int i, failed = 0;
 	int bo_ret = OPTIONS_OKAY;
 	double time;
 	struct measurements_t measurements;
@@ -35,8 +37,7 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	size_t begin = 0, end = 0;
 	size_t min_message_size = options.min_message_size;
@@ -56,7 +57,6 @@ int main(int argc, char* argv[]) {
 	    malloc(stride_count * sizeof(gaspi_offset_t));
 
 	const gaspi_queue_id_t q_id = 0;
-	gaspi_pointer_t ptr;
 
 	print_header(my_id);
 	size_t segment_idx = 0;
@@ -71,10 +71,16 @@ int main(int argc, char* argv[]) {
 		                      my_id == 0 ? 'a' : 'b');
 	}
 
+	if (options.verify) {
+		for (size_t k = 0; k < stride_count; ++k) {
+			verify_prepare(segment_ids[k], sizes[k], 0, sizes[k]);
+		}
+	}
+
 	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
 
 	if (my_id == 0) {
-		for (i = 0; i < options.iterations + options.skip; ++i) {
+		for (i = 0; measure_continue(&measurements, i, MEASURE_LOCAL); ++i) {
 			if (i >= options.skip) {
 				time = stopwatch_start();
 			}
@@ -89,23 +95,21 @@ int main(int argc, char* argv[]) {
 			                             GASPI_BLOCK));
 			GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
 			if (i >= options.skip) {
-				measurements.time[i - options.skip] = stopwatch_stop(time);
+				record_measurement(&measurements,
+				                   i - options.skip,
+				                   time,
+				                   stopwatch_stop(time));
 			}
 		}
 	}
 	if (options.verify) {
-		GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-	}
-	if (my_id == 1 && options.verify) {
-		for (int i = 0; i < stride_count; ++i) {
-			GASPI_CHECK(gaspi_segment_ptr(segment_ids[i], &ptr));
-			for (int u = 0; u < sizes[i]; ++u) {
-				if (((char*) ptr)[u] != 'a') {
-					fprintf(stderr,
-					        "Verification failed. Result is invalid!\n");
-					return EXIT_FAILURE;
-				}
-			}
+		for (size_t k = 0; k < stride_count; ++k) {
+			failed |=
+			    !verify_received(segment_ids[k], sizes[k], 0, sizes[k]);
+		}
+		if (failed) {
+			fprintf(stderr, "Verification failed. Result is invalid!\n");
+			return EXIT_FAILURE;
 		}
 	}
 
@@ -119,7 +123,7 @@ int main(int argc, char* argv[]) {
 	free(local_offsets);
 	free(remote_offsets);
 	free(sizes);
-	free(measurements.time);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
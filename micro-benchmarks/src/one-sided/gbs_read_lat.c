@@ -1,20 +1,28 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_offsets.h"
+#include "util_sweep.h"
+#include "util_verify.h"
+#include "util_wait.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
 	size_t size;
+	gaspi_offset_t offset;
 	int i;
 	int bo_ret = OPTIONS_OKAY;
 	double time;
+	uint64_t seed = 0;
 	struct measurements_t measurements;
 
 	options.type = ONESIDED;
 	options.subtype = LAT;
 	options.name = "gbs_read_lat";
 
+	verify_every_enable();
 	bo_ret = benchmark_options(argc, argv);
 
 	switch (bo_ret) {
@@ -35,44 +43,48 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id = 0;
 	const gaspi_queue_id_t q_id = 0;
-	gaspi_pointer_t ptr;
 
 	print_header(my_id);
 
 	if (options.single_buffer) {
-		allocate_gaspi_memory(segment_id,
-		                      options.max_message_size * sizeof(char),
-		                      my_id == 0 ? 'a' : 'b');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		allocate_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)),
+		    my_id == 0 ? 'a' : 'b');
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
+					if (verify_iteration(i)) {
+						seed = verify_seed(my_id, size, i);
+						verify_push(segment_id, 0, size, 1, seed);
+					}
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
+					offset = offsets_next(size, 0);
 					GASPI_CHECK(gaspi_read(segment_id,
-					                       0,
+					                       offset,
 					                       1,
 					                       segment_id,
-					                       0,
+					                       offset,
 					                       size,
 					                       q_id,
 					                       GASPI_BLOCK));
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+					wait_queue(q_id);
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
-				}
-				if (options.verify) {
-					for (i = 0; i < size; ++i) {
-						if (((char*) ptr)[i] != 'b') {
+					if (verify_iteration(i)) {
+						if (!verify_check(segment_id, 0, size, seed)) {
 							fprintf(
 							    stderr,
 							    "Verification failed. Result is invalid!\n");
@@ -86,33 +98,42 @@ int main(int argc, char* argv[]) {
 		free_gaspi_memory(segment_id);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
-			allocate_gaspi_memory(
-			    segment_id, size * sizeof(char), my_id == 0 ? 'a' : 'b');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+		reserve_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			allocate_gaspi_memory(segment_id,
+			                      offsets_footprint(size * sizeof(char)),
+			                      my_id == 0 ? 'a' : 'b');
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
+					if (verify_iteration(i)) {
+						seed = verify_seed(my_id, size, i);
+						verify_push(segment_id, 0, size, 1, seed);
+					}
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
+					offset = offsets_next(size, 0);
 					GASPI_CHECK(gaspi_read(segment_id,
-					                       0,
+					                       offset,
 					                       1,
 					                       segment_id,
-					                       0,
+					                       offset,
 					                       size,
 					                       q_id,
 					                       GASPI_BLOCK));
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+					wait_queue(q_id);
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
-				}
-				if (options.verify) {
-					for (i = 0; i < size; ++i) {
-						if (((char*) ptr)[i] != 'b') {
+					if (verify_iteration(i)) {
+						if (!verify_check(segment_id, 0, size, seed)) {
 							fprintf(
 							    stderr,
 							    "Verification failed. Result is invalid!\n");
@@ -125,7 +146,8 @@ int main(int argc, char* argv[]) {
 			free_gaspi_memory(segment_id);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
@@ -1,21 +1,55 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_offsets.h"
+#include "util_stripe.h"
+#include "util_sweep.h"
+#include "util_sync.h"
+#include "util_verify.h"
+
+static const gaspi_segment_id_t segment_id_send = 0;
+static const gaspi_segment_id_t segment_id_recv = 1;
+static const gaspi_queue_id_t q_id = 0;
+
+// new pattern to send, both ranks clear their receive buffer before going on
+static void prepare_verify(const gaspi_rank_t my_id,
+                           const size_t size,
+                           const int i,
+                           const size_t bytes) {
+	verify_fill(segment_id_send, 0, bytes, verify_seed(my_id, size, i));
+	verify_clear(segment_id_recv, 0, bytes);
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+}
+
+// the iteration ended with a pair sync, the partner's pattern has arrived
+static int check_verify(const gaspi_rank_t my_id,
+                        const size_t size,
+                        const int i,
+                        const size_t bytes) {
+	if (!verify_check(
+	        segment_id_recv, 0, bytes, verify_seed(1 - my_id, size, i))) {
+		fprintf(stderr, "Verification failed. Result is invalid!\n");
+		return 0;
+	}
+	return 1;
+}
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
 	size_t size;
+	gaspi_offset_t offset;
 	int i, j;
 	int bo_ret = OPTIONS_OKAY;
 	double time;
-	char check_val;
 	struct measurements_t measurements;
 
 	options.type = ONESIDED;
 	options.subtype = BW;
 	options.name = "gbs_write_bibw";
 
+	verify_every_enable();
 	bo_ret = benchmark_options(argc, argv);
 
 	switch (bo_ret) {
@@ -36,150 +70,176 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
-
-	const gaspi_segment_id_t segment_id_send = 0;
-	const gaspi_segment_id_t segment_id_recv = 1;
-	const gaspi_queue_id_t q_id = 0;
-	gaspi_pointer_t ptr;
+	init_measurements(&measurements);
 
+	pair_sync_enable(1);
 	print_header(my_id);
 
 	int window_size = options.window_size;
 	if (options.single_buffer) {
-		allocate_gaspi_memory(segment_id_send,
-		                      options.max_message_size * sizeof(char),
-		                      my_id == 0 ? 'a' : 'b');
 		allocate_gaspi_memory(
-		    segment_id_recv, options.max_message_size * sizeof(char), 'y');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id_recv, &ptr));
+		    segment_id_send,
+		    offsets_footprint(options.max_message_size * sizeof(char)),
+		    my_id == 0 ? 'a' : 'b');
+		allocate_gaspi_memory(
+		    segment_id_recv,
+		    offsets_footprint(options.max_message_size * sizeof(char)),
+		    'y');
 
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
 			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+			pair_sync_calibrate(segment_id_recv, 1 - my_id, q_id);
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
+					if (verify_iteration(i)) {
+						prepare_verify(my_id, size, i, size);
+					}
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
 					for (j = 0; j < window_size; ++j) {
-						GASPI_CHECK(gaspi_write(segment_id_send,
-						                        0,
-						                        1,
-						                        segment_id_recv,
-						                        0,
-						                        size,
-						                        q_id,
-						                        GASPI_BLOCK));
-					}
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
-					GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+						offset = offsets_next(size, 0);
+						stripe_write(segment_id_send,
+						             offset,
+						             1,
+						             segment_id_recv,
+						             offset,
+						             size);
+					}
+					stripe_wait();
+					pair_sync(segment_id_recv, 1 - my_id, q_id);
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
+					}
+					if (verify_iteration(i) &&
+					    !check_verify(my_id, size, i, size)) {
+						return EXIT_FAILURE;
 					}
 				}
 			}
 			else if (my_id == 1) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
+					if (verify_iteration(i)) {
+						prepare_verify(my_id, size, i, size);
+					}
 					for (j = 0; j < window_size; ++j) {
-						GASPI_CHECK(gaspi_write(segment_id_send,
-						                        0,
-						                        0,
-						                        segment_id_recv,
-						                        0,
-						                        size,
-						                        q_id,
-						                        GASPI_BLOCK));
-					}
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
-					GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-				}
-			}
-			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			if (options.verify) {
-				check_val = my_id == 0 ? 'b' : 'a';
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != check_val) {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
+						offset = offsets_next(size, 0);
+						stripe_write(segment_id_send,
+						             offset,
+						             0,
+						             segment_id_recv,
+						             offset,
+						             size);
+					}
+					stripe_wait();
+					pair_sync(segment_id_recv, 1 - my_id, q_id);
+					if (verify_iteration(i) &&
+					    !check_verify(my_id, size, i, size)) {
 						return EXIT_FAILURE;
 					}
 				}
 			}
+			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
 			print_result(my_id, measurements, size * 2);
 		}
 		free_gaspi_memory(segment_id_send);
 		free_gaspi_memory(segment_id_recv);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
-			allocate_gaspi_memory(segment_id_send,
-			                      size * window_size * sizeof(char),
-			                      my_id == 0 ? 'a' : 'b');
+		reserve_gaspi_memory(
+		    segment_id_send,
+		    offsets_footprint(options.max_message_size * sweep_max_window() *
+		                      sizeof(char)));
+		reserve_gaspi_memory(
+		    segment_id_recv,
+		    offsets_footprint(options.max_message_size * sweep_max_window() *
+		                      sizeof(char)));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
 			allocate_gaspi_memory(
-			    segment_id_recv, size * window_size * sizeof(char), 'y');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id_recv, &ptr));
-
+			    segment_id_send,
+			    offsets_footprint(size * window_size * sizeof(char)),
+			    my_id == 0 ? 'a' : 'b');
+			allocate_gaspi_memory(
+			    segment_id_recv,
+			    offsets_footprint(size * window_size * sizeof(char)),
+			    'y');
+	
 			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+			pair_sync_calibrate(segment_id_recv, 1 - my_id, q_id);
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
+					if (verify_iteration(i)) {
+						prepare_verify(my_id, size, i, size * window_size);
+					}
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
 					for (j = 0; j < window_size; ++j) {
-						GASPI_CHECK(gaspi_write(segment_id_send,
-						                        j * size,
-						                        1,
-						                        segment_id_recv,
-						                        j * size,
-						                        size,
-						                        q_id,
-						                        GASPI_BLOCK));
-					}
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
-					GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+						offset = offsets_next(size, j * size);
+						stripe_write(segment_id_send,
+						             offset,
+						             1,
+						             segment_id_recv,
+						             offset,
+						             size);
+					}
+					stripe_wait();
+					pair_sync(segment_id_recv, 1 - my_id, q_id);
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
+					}
+					if (verify_iteration(i) &&
+					    !check_verify(my_id, size, i, size * window_size)) {
+						return EXIT_FAILURE;
 					}
 				}
 			}
 			else if (my_id == 1) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+				     ++i) {
+					if (verify_iteration(i)) {
+						prepare_verify(my_id, size, i, size * window_size);
+					}
 					for (j = 0; j < window_size; ++j) {
-						GASPI_CHECK(gaspi_write(segment_id_send,
-						                        j * size,
-						                        0,
-						                        segment_id_recv,
-						                        j * size,
-						                        size,
-						                        q_id,
-						                        GASPI_BLOCK));
-					}
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
-					GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-				}
-			}
-			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			if (options.verify) {
-				check_val = my_id == 0 ? 'b' : 'a';
-				for (i = 0; i < size * window_size; ++i) {
-					if (((char*) ptr)[i] != check_val) {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
+						offset = offsets_next(size, j * size);
+						stripe_write(segment_id_send,
+						             offset,
+						             0,
+						             segment_id_recv,
+						             offset,
+						             size);
+					}
+					stripe_wait();
+					pair_sync(segment_id_recv, 1 - my_id, q_id);
+					if (verify_iteration(i) &&
+					    !check_verify(my_id, size, i, size * window_size)) {
 						return EXIT_FAILURE;
 					}
 				}
 			}
+			GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
 			print_result(my_id, measurements, size * 2);
 			free_gaspi_memory(segment_id_send);
 			free_gaspi_memory(segment_id_recv);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
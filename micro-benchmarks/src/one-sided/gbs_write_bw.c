@@ -1,14 +1,21 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_offsets.h"
+#include "util_stripe.h"
+#include "util_sweep.h"
+#include "util_verify.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
 	size_t size;
+	gaspi_offset_t offset;
 	int i, j;
 	int bo_ret = OPTIONS_OKAY;
 	double time;
+	uint64_t seed = 0;
 
 	options.type = ONESIDED;
 	options.subtype = BW;
@@ -16,6 +23,7 @@ int main(int argc, char* argv[]) {
 
 	struct measurements_t measurements;
 
+	verify_every_enable();
 	bo_ret = benchmark_options(argc, argv);
 
 	switch (bo_ret) {
@@ -36,108 +44,116 @@ int main(int argc, char* argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id = 0;
-	const gaspi_queue_id_t q_id = 0;
-	gaspi_pointer_t ptr;
 
 	print_header(my_id);
 
 	int window_size = options.window_size;
 	if (options.single_buffer) {
-		allocate_gaspi_memory(segment_id,
-		                      options.max_message_size * sizeof(char),
-		                      my_id == 0 ? 'a' : 'b');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		allocate_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sizeof(char)),
+		    my_id == 0 ? 'a' : 'b');
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
+					if (verify_iteration(i)) {
+						seed = verify_seed(my_id, size, i);
+						verify_fill(segment_id, 0, size, seed);
+					}
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
 					for (j = 0; j < window_size; ++j) {
-						GASPI_CHECK(gaspi_write(segment_id,
-						                        0,
-						                        1,
-						                        segment_id,
-						                        0,
-						                        size,
-						                        q_id,
-						                        GASPI_BLOCK));
+						offset = offsets_next(size, 0);
+						stripe_write(
+						    segment_id, offset, 1, segment_id, offset, size);
 					}
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+					stripe_complete();
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
-				}
-			}
-			if (options.verify) {
-				GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			}
-			if (my_id == 1 && options.verify) {
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
+					if (verify_iteration(i)) {
+						stripe_wait();
+						if (!verify_pull(segment_id, 0, size, 1, seed)) {
+							fprintf(
+							    stderr,
+							    "Verification failed. Result is invalid!\n");
+							return EXIT_FAILURE;
+						}
 					}
 				}
+				stripe_wait();
 			}
 			print_result(my_id, measurements, size);
 		}
 		free_gaspi_memory(segment_id);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
-			allocate_gaspi_memory(segment_id,
-			                      size * window_size * sizeof(char),
-			                      my_id == 0 ? 'a' : 'b');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+		reserve_gaspi_memory(
+		    segment_id,
+		    offsets_footprint(options.max_message_size * sweep_max_window() *
+		                      sizeof(char)));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
+			allocate_gaspi_memory(
+			    segment_id,
+			    offsets_footprint(size * window_size * sizeof(char)),
+			    my_id == 0 ? 'a' : 'b');
 			if (my_id == 0) {
-				for (i = 0; i < options.iterations + options.skip; ++i) {
+				for (i = 0;
+				     measure_continue(&measurements, i, MEASURE_LOCAL);
+				     ++i) {
+					if (verify_iteration(i)) {
+						seed = verify_seed(my_id, size, i);
+						verify_fill(segment_id, 0, size * window_size, seed);
+					}
 					if (i >= options.skip) {
 						time = stopwatch_start();
 					}
 					for (j = 0; j < window_size; ++j) {
-						GASPI_CHECK(gaspi_write(segment_id,
-						                        j * size,
-						                        1,
-						                        segment_id,
-						                        j * size,
-						                        size,
-						                        q_id,
-						                        GASPI_BLOCK));
+						offset = offsets_next(size, j * size);
+						stripe_write(
+						    segment_id, offset, 1, segment_id, offset, size);
 					}
-					GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+					stripe_complete();
 					if (i >= options.skip) {
-						measurements.time[i - options.skip] =
-						    stopwatch_stop(time);
+						record_measurement(&measurements,
+						                   i - options.skip,
+						                   time,
+						                   stopwatch_stop(time));
 					}
-				}
-			}
-			if (options.verify) {
-				GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-			}
-			if (my_id == 1 && options.verify) {
-				for (i = 0; i < size * window_size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
+					if (verify_iteration(i)) {
+						stripe_wait();
+						if (!verify_pull(segment_id,
+						                 0,
+						                 size * window_size,
+						                 1,
+						                 seed)) {
+							fprintf(
+							    stderr,
+							    "Verification failed. Result is invalid!\n");
+							return EXIT_FAILURE;
+						}
 					}
 				}
+				stripe_wait();
 			}
 
 			print_result(my_id, measurements, size);
 			free_gaspi_memory(segment_id);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
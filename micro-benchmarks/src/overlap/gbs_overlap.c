@@ -0,0 +1,259 @@
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_memory.h"
+#include "util_sweep.h"
+
+/*
+ * Overlap of one operation with a calibrated compute kernel: every iteration
+ * posts the operation, computes for as long as the operation alone takes (or
+ * --compute-time) and completes it. The variants are selected at compile
+ * time: gaspi_write, gaspi_write_notify and gaspi_read from rank 0 to rank 1
+ * or gaspi_allreduce(GASPI_TEST) of message size doubles on all ranks.
+ */
+#if defined(OVERLAP_ALLREDUCE)
+#define OVERLAP_NAME "gbs_overlap_allreduce"
+#define MEASURE_MODE MEASURE_COLLECTIVE
+#elif defined(OVERLAP_WRITE_NOTIFY)
+#define OVERLAP_NAME "gbs_overlap_write_notify"
+#define MEASURE_MODE MEASURE_LOCAL
+#elif defined(OVERLAP_READ)
+#define OVERLAP_NAME "gbs_overlap_read"
+#define MEASURE_MODE MEASURE_LOCAL
+#else
+#define OVERLAP_NAME "gbs_overlap_write"
+#define MEASURE_MODE MEASURE_LOCAL
+#endif
+
+#define CALIBRATION_STEPS (1 << 20)
+#define CALIBRATION_RUNS 5
+
+static const gaspi_segment_id_t segment_id = 0;
+static double ns_per_step;
+static volatile double sink = 1.0;
+
+#if defined(OVERLAP_ALLREDUCE)
+static double* one;
+static double* sum;
+static int reduced;
+#else
+static const gaspi_queue_id_t q_id = 0;
+#endif
+
+// a dependent chain of floating point operations, starting from the volatile
+// sink so that the compiler can neither vectorize nor precompute it
+static void compute_steps(const long steps) {
+	double x = sink;
+	long s;
+
+	for (s = 0; s < steps; ++s) {
+		x = x * 0.999999 + 1e-6;
+	}
+	sink = x;
+}
+
+static void compute(const double ns) {
+	compute_steps((long) (ns / ns_per_step));
+}
+
+// fastest of several runs, the kernel is then timed without interruptions
+static void calibrate(void) {
+	double time, fastest = 0;
+	int r;
+
+	for (r = 0; r < CALIBRATION_RUNS; ++r) {
+		time = stopwatch_start();
+		compute_steps(CALIBRATION_STEPS);
+		time = stopwatch_stop(time);
+		if (r == 0 || time < fastest) {
+			fastest = time;
+		}
+	}
+	ns_per_step = fastest / CALIBRATION_STEPS;
+}
+
+static void post(const size_t size) {
+#if defined(OVERLAP_ALLREDUCE)
+	const gaspi_return_t ret = gaspi_allreduce(one,
+	                                           sum,
+	                                           size,
+	                                           GASPI_OP_SUM,
+	                                           GASPI_TYPE_DOUBLE,
+	                                           GASPI_GROUP_ALL,
+	                                           GASPI_TEST);
+	if (ret != GASPI_TIMEOUT) {
+		GASPI_CHECK(ret);
+	}
+	reduced = ret == GASPI_SUCCESS;
+#elif defined(OVERLAP_WRITE_NOTIFY)
+	GASPI_CHECK(gaspi_write_notify(
+	    segment_id, 0, 1, segment_id, 0, size, 0, 1, q_id, GASPI_BLOCK));
+#elif defined(OVERLAP_READ)
+	GASPI_CHECK(
+	    gaspi_read(segment_id, 0, 1, segment_id, 0, size, q_id, GASPI_BLOCK));
+#else
+	GASPI_CHECK(
+	    gaspi_write(segment_id, 0, 1, segment_id, 0, size, q_id, GASPI_BLOCK));
+#endif
+}
+
+// one call into the library, returns whether the operation has completed
+static int test(const size_t size) {
+	gaspi_return_t ret;
+
+#if defined(OVERLAP_ALLREDUCE)
+	if (reduced) {
+		return 1;
+	}
+	ret = gaspi_allreduce(one,
+	                      sum,
+	                      size,
+	                      GASPI_OP_SUM,
+	                      GASPI_TYPE_DOUBLE,
+	                      GASPI_GROUP_ALL,
+	                      GASPI_TEST);
+	reduced = ret == GASPI_SUCCESS;
+#else
+	ret = gaspi_wait(q_id, GASPI_TEST);
+#endif
+	if (ret != GASPI_TIMEOUT) {
+		GASPI_CHECK(ret);
+	}
+	return ret == GASPI_SUCCESS;
+}
+
+static void complete(const size_t size) {
+#if defined(OVERLAP_ALLREDUCE)
+	while (!test(size)) {
+	}
+#else
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+#endif
+}
+
+// rank 1 is only the target of the point-to-point operations
+static int active(const gaspi_rank_t id) {
+#if defined(OVERLAP_ALLREDUCE)
+	return 1;
+#else
+	return id == 0;
+#endif
+}
+
+// mean time of the operation without computation in ns
+static double communication_time(const size_t size) {
+	double time, total = 0;
+	int i;
+
+	for (i = 0; i < options.skip + options.iterations; ++i) {
+		time = stopwatch_start();
+		post(size);
+		complete(size);
+		time = stopwatch_stop(time);
+		if (i >= options.skip) {
+			total += time;
+		}
+	}
+	return total / options.iterations;
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t my_id, num_pes;
+	size_t size;
+	int i, progressed;
+	int bo_ret = OPTIONS_OKAY;
+	double time, communication, cpu;
+	struct measurements_t measurements;
+
+	options.type = ONESIDED;
+	options.subtype = OVERLAP;
+	options.name = OVERLAP_NAME;
+
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	if (num_pes < 2) {
+		fprintf(stderr, "Benchmark requires at least two processes!\n");
+		return EXIT_FAILURE;
+	}
+
+	init_measurements(&measurements);
+	calibrate();
+
+#if defined(OVERLAP_ALLREDUCE)
+	gaspi_number_t elem_max;
+	GASPI_CHECK(gaspi_allreduce_elem_max(&elem_max));
+	if (options.max_message_size > elem_max) {
+		options.max_message_size = elem_max;
+	}
+	one = malloc(options.max_message_size * sizeof(double));
+	sum = malloc(options.max_message_size * sizeof(double));
+	for (i = 0; i < options.max_message_size; ++i) {
+		one[i] = 1.0;
+	}
+#endif
+
+	print_header(my_id);
+
+	reserve_gaspi_memory(segment_id, options.max_message_size);
+	for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+		allocate_gaspi_memory(segment_id, size, my_id == 0 ? 'a' : 'b');
+		progressed = 0;
+		communication = 0;
+		cpu = 0;
+		if (active(my_id)) {
+			communication = communication_time(size);
+			cpu = options.compute_time > 0 ? options.compute_time * 1e3
+			                               : communication;
+			for (i = 0; measure_continue(&measurements, i, MEASURE_MODE);
+			     ++i) {
+				if (i >= options.skip) {
+					time = stopwatch_start();
+				}
+				post(size);
+				compute(cpu);
+				if (test(size)) {
+					progressed += i >= options.skip;
+				}
+				else {
+					complete(size);
+				}
+				if (i >= options.skip) {
+					record_measurement(&measurements,
+					                   i - options.skip,
+					                   time,
+					                   stopwatch_stop(time));
+				}
+			}
+		}
+		print_overlap_result(my_id,
+		                     measurements,
+		                     size,
+		                     communication,
+		                     cpu,
+		                     (double) progressed / measurements.n);
+		free_gaspi_memory(segment_id);
+	}
+
+#if defined(OVERLAP_ALLREDUCE)
+	free(one);
+	free(sum);
+#endif
+	print_registration(my_id);
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
@@ -1,7 +1,10 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_sweep.h"
+#include "util_verify.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
@@ -48,13 +51,11 @@ int main(int argc, char* argv[]) {
 		options.max_message_size = max_transfer_size;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id_a = 0;
 	const gaspi_segment_id_t segment_id_b = 1;
 	gaspi_rank_t remote_id = my_id == 0 ? 1 : 0;
-	gaspi_pointer_t ptr;
 
 	print_header(my_id);
 
@@ -64,10 +65,14 @@ int main(int argc, char* argv[]) {
 		                      options.max_message_size * sizeof(char),
 		                      my_id == 0 ? 'a' : 'b');
 		allocate_gaspi_memory(segment_id_b, sizeof(char), 'a');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id_a, &ptr));
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
-			for (i = 0; i < options.iterations + options.skip; ++i) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
+			if (options.verify) {
+				verify_prepare(segment_id_a, size, 0, size);
+			}
+			for (i = 0;
+			     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+			     ++i) {
 				if (i >= options.skip) {
 					time = stopwatch_start();
 				}
@@ -91,17 +96,16 @@ int main(int argc, char* argv[]) {
 					    segment_id_b, 0, 0, sizeof(char), GASPI_BLOCK));
 				}
 				if (i >= options.skip) {
-					measurements.time[i - options.skip] = stopwatch_stop(time);
+					record_measurement(&measurements,
+					                   i - options.skip,
+					                   time,
+					                   stopwatch_stop(time));
 				}
 			}
-			if (my_id == 1 && options.verify) {
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_received(segment_id_a, size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 			print_result(my_id, measurements, size);
 		}
@@ -109,14 +113,21 @@ int main(int argc, char* argv[]) {
 		free_gaspi_memory(segment_id_b);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		reserve_gaspi_memory(
+		    segment_id_a,
+		    options.max_message_size * sweep_max_window() * sizeof(char));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			window_size = options.window_size;
 			allocate_gaspi_memory(segment_id_a,
 			                      size * window_size * sizeof(char),
 			                      my_id == 0 ? 'a' : 'b');
 			allocate_gaspi_memory(segment_id_b, sizeof(char), 'a');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id_a, &ptr));
-			for (i = 0; i < options.iterations + options.skip; ++i) {
+			if (options.verify) {
+				verify_prepare(segment_id_a, size * window_size, 0, size);
+			}
+			for (i = 0;
+			     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+			     ++i) {
 				if (i >= options.skip) {
 					time = stopwatch_start();
 				}
@@ -143,24 +154,25 @@ int main(int argc, char* argv[]) {
 					    segment_id_b, 0, 0, sizeof(char), GASPI_BLOCK));
 				}
 				if (i >= options.skip) {
-					measurements.time[i - options.skip] = stopwatch_stop(time);
+					record_measurement(&measurements,
+					                   i - options.skip,
+					                   time,
+					                   stopwatch_stop(time));
 				}
 			}
-			if (my_id == 1 && options.verify) {
-				for (i = 0; i < size * window_size; ++i) {
-					if (((char*) ptr)[i] != 'a') {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
-				}
+			if (options.verify &&
+			    !verify_received(
+			        segment_id_a, size * window_size, 0, size)) {
+				fprintf(stderr, "Verification failed. Result is invalid!\n");
+				return EXIT_FAILURE;
 			}
 			print_result(my_id, measurements, size);
 			free_gaspi_memory(segment_id_a);
 			free_gaspi_memory(segment_id_b);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
@@ -1,7 +1,10 @@
 #include "check.h"
 #include "stopwatch.h"
 #include "util.h"
+#include "util_adaptive.h"
 #include "util_memory.h"
+#include "util_sweep.h"
+#include "util_verify.h"
 
 int main(int argc, char* argv[]) {
 	gaspi_rank_t my_id, num_pes;
@@ -47,13 +50,12 @@ int main(int argc, char* argv[]) {
 		options.max_message_size = max_transfer_size;
 	}
 
-	measurements.time = malloc(options.iterations * sizeof(double));
-	measurements.n = options.iterations;
+	init_measurements(&measurements);
 
 	const gaspi_segment_id_t segment_id_a = 0;
 	const gaspi_segment_id_t segment_id_b = 1;
 	gaspi_rank_t remote_id = my_id == 0 ? 1 : 0;
-	gaspi_pointer_t ptr_a, ptr_b;
+	int failed;
 
 	print_header(my_id);
 
@@ -64,12 +66,16 @@ int main(int argc, char* argv[]) {
 		allocate_gaspi_memory(segment_id_b,
 		                      options.max_message_size * sizeof(char),
 		                      my_id == 0 ? 'a' : 'b');
-		GASPI_CHECK(gaspi_segment_ptr(segment_id_a, &ptr_a));
-		GASPI_CHECK(gaspi_segment_ptr(segment_id_b, &ptr_b));
 
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
-			for (i = 0; i < options.iterations + options.skip; ++i) {
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			if (options.verify) {
+				// rank 0 sends through segment a, rank 1 through segment b
+				verify_prepare(segment_id_a, size, 0, size);
+				verify_prepare(segment_id_b, size, 1, size);
+			}
+			for (i = 0;
+			     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+			     ++i) {
 				if (i >= options.skip) {
 					time = stopwatch_start();
 				}
@@ -86,20 +92,20 @@ int main(int argc, char* argv[]) {
 					    segment_id_b, 0, 0, size, GASPI_BLOCK));
 				}
 				if (i >= options.skip) {
-					measurements.time[i - options.skip] = stopwatch_stop(time);
-					measurements.time[i - options.skip] /=
-					    2.0; // send-receive special case
+					// send-receive special case
+					record_round_trip(&measurements,
+					                  i - options.skip,
+					                  time,
+					                  stopwatch_stop(time));
 				}
 			}
 			if (options.verify) {
-				const gaspi_pointer_t ptr = my_id == 0 ? ptr_b : ptr_a;
-				const char check_val = my_id == 0 ? 'b' : 'a';
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != check_val) {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
+				failed = !verify_received(segment_id_a, size, 0, size);
+				failed |= !verify_received(segment_id_b, size, 1, size);
+				if (failed) {
+					fprintf(stderr,
+					        "Verification failed. Result is invalid!\n");
+					return EXIT_FAILURE;
 				}
 			}
 			print_result(my_id, measurements, size);
@@ -108,15 +114,22 @@ int main(int argc, char* argv[]) {
 		free_gaspi_memory(segment_id_b);
 	}
 	else {
-		for (size = options.min_message_size; size <= options.max_message_size;
-		     size *= 2) {
+		reserve_gaspi_memory(segment_id_a,
+		                     options.max_message_size * sizeof(char));
+		reserve_gaspi_memory(segment_id_b,
+		                     options.max_message_size * sizeof(char));
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
 			allocate_gaspi_memory(
 			    segment_id_a, size * sizeof(char), my_id == 0 ? 'a' : 'b');
 			allocate_gaspi_memory(
 			    segment_id_b, size * sizeof(char), my_id == 0 ? 'a' : 'b');
-			GASPI_CHECK(gaspi_segment_ptr(segment_id_a, &ptr_a));
-			GASPI_CHECK(gaspi_segment_ptr(segment_id_b, &ptr_b));
-			for (i = 0; i < options.iterations + options.skip; ++i) {
+			if (options.verify) {
+				verify_prepare(segment_id_a, size, 0, size);
+				verify_prepare(segment_id_b, size, 1, size);
+			}
+			for (i = 0;
+			     measure_continue(&measurements, i, MEASURE_COLLECTIVE);
+			     ++i) {
 				if (i >= options.skip) {
 					time = stopwatch_start();
 				}
@@ -133,18 +146,19 @@ int main(int argc, char* argv[]) {
 					    segment_id_b, 0, 0, size, GASPI_BLOCK));
 				}
 				if (i >= options.skip) {
-					measurements.time[i - options.skip] = stopwatch_stop(time);
+					record_measurement(&measurements,
+					                   i - options.skip,
+					                   time,
+					                   stopwatch_stop(time));
 				}
 			}
 			if (options.verify) {
-				const gaspi_pointer_t ptr = my_id == 0 ? ptr_b : ptr_a;
-				const char check_val = my_id == 0 ? 'b' : 'a';
-				for (i = 0; i < size; ++i) {
-					if (((char*) ptr)[i] != check_val) {
-						fprintf(stderr,
-						        "Verification failed. Result is invalid!\n");
-						return EXIT_FAILURE;
-					}
+				failed = !verify_received(segment_id_a, size, 0, size);
+				failed |= !verify_received(segment_id_b, size, 1, size);
+				if (failed) {
+					fprintf(stderr,
+					        "Verification failed. Result is invalid!\n");
+					return EXIT_FAILURE;
 				}
 			}
 			print_result(my_id, measurements, size);
@@ -152,7 +166,8 @@ int main(int argc, char* argv[]) {
 			free_gaspi_memory(segment_id_b);
 		}
 	}
-	free(measurements.time);
+	print_registration(my_id);
+	free_measurements(&measurements);
 	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
 	return EXIT_SUCCESS;
 }
@@ -0,0 +1,214 @@
+#include <sys/mman.h>
+#include "check.h"
+#include "stopwatch.h"
+#include "util.h"
+#include "util_adaptive.h"
+#include "util_sweep.h"
+
+/*
+ * Cost of the segment management calls per segment size and group size.
+ * Every operation is timed on its own: prepare and cleanup run outside of
+ * the timed region, e.g. the segment a registration or deletion works on.
+ * The memory handed to bind and use is either untouched, so the pinning
+ * faults it in, or written once beforehand.
+ */
+struct operation_t {
+	const char* name;
+	int needs_peers;
+	void (*prepare)(const size_t size);
+	void (*timed)(const size_t size);
+	void (*cleanup)(const size_t size);
+};
+
+static const gaspi_segment_id_t segment_id = 0;
+static gaspi_group_t group;
+static gaspi_rank_t group_size;
+static gaspi_rank_t my_id;
+static void* memory;
+
+static void map_memory(const size_t size) {
+	memory = mmap(NULL,
+	              size,
+	              PROT_READ | PROT_WRITE,
+	              MAP_PRIVATE | MAP_ANONYMOUS,
+	              -1,
+	              0);
+	if (memory == MAP_FAILED) {
+		fprintf(stderr, "Cannot map %zu bytes\n", size);
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void touch_memory(const size_t size) {
+	map_memory(size);
+	memset(memory, 1, size);
+}
+
+static void alloc_segment(const size_t size) {
+	GASPI_CHECK(gaspi_segment_alloc(segment_id, size, GASPI_MEM_UNINITIALIZED));
+}
+
+static void alloc_segment_initialized(const size_t size) {
+	GASPI_CHECK(gaspi_segment_alloc(segment_id, size, GASPI_MEM_INITIALIZED));
+}
+
+// with every other member of the group, as gaspi_segment_create does
+static void register_segment(const size_t size) {
+	gaspi_rank_t r;
+
+	for (r = 0; r < group_size; ++r) {
+		if (r != my_id) {
+			GASPI_CHECK(gaspi_segment_register(segment_id, r, GASPI_BLOCK));
+		}
+	}
+}
+
+static void create_segment(const size_t size) {
+	GASPI_CHECK(gaspi_segment_create(
+	    segment_id, size, group, GASPI_BLOCK, GASPI_MEM_UNINITIALIZED));
+}
+
+static void create_segment_initialized(const size_t size) {
+	GASPI_CHECK(gaspi_segment_create(
+	    segment_id, size, group, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+}
+
+static void bind_segment(const size_t size) {
+	GASPI_CHECK(gaspi_segment_bind(segment_id, memory, size, 0));
+}
+
+static void use_segment(const size_t size) {
+	GASPI_CHECK(
+	    gaspi_segment_use(segment_id, memory, size, group, GASPI_BLOCK, 0));
+}
+
+static void delete_segment(const size_t size) {
+	GASPI_CHECK(gaspi_segment_delete(segment_id));
+}
+
+static void delete_segment_unmap(const size_t size) {
+	GASPI_CHECK(gaspi_segment_delete(segment_id));
+	munmap(memory, size);
+}
+
+static const struct operation_t operations[] = {
+    {"alloc", 0, NULL, alloc_segment, delete_segment},
+    {"alloc_init", 0, NULL, alloc_segment_initialized, delete_segment},
+    {"register", 1, alloc_segment, register_segment, delete_segment},
+    {"create", 0, NULL, create_segment, delete_segment},
+    {"create_init", 0, NULL, create_segment_initialized, delete_segment},
+    {"bind", 0, map_memory, bind_segment, delete_segment_unmap},
+    {"bind_touched", 0, touch_memory, bind_segment, delete_segment_unmap},
+    {"use", 0, map_memory, use_segment, delete_segment_unmap},
+    {"use_touched", 0, touch_memory, use_segment, delete_segment_unmap},
+    {"delete", 0, create_segment, delete_segment, NULL}};
+
+static void time_operation(const struct operation_t* operation,
+                           const size_t size,
+                           struct measurements_t* measurements) {
+	double time;
+	int i;
+
+	for (i = 0; measure_continue(measurements, i, MEASURE_LOCAL); ++i) {
+		if (operation->prepare != NULL) {
+			operation->prepare(size);
+		}
+		// start the collective calls together
+		GASPI_CHECK(gaspi_barrier(group, GASPI_BLOCK));
+		if (i >= options.skip) {
+			time = stopwatch_start();
+		}
+		operation->timed(size);
+		if (i >= options.skip) {
+			record_measurement(
+			    measurements, i - options.skip, time, stopwatch_stop(time));
+		}
+		if (operation->cleanup != NULL) {
+			operation->cleanup(size);
+		}
+		GASPI_CHECK(gaspi_barrier(group, GASPI_BLOCK));
+	}
+}
+
+// group of the first n ranks, only created on its members
+static void create_group(const gaspi_rank_t n) {
+	gaspi_rank_t r;
+
+	group_size = n;
+	if (my_id >= n) {
+		return;
+	}
+	GASPI_CHECK(gaspi_group_create(&group));
+	for (r = 0; r < n; ++r) {
+		GASPI_CHECK(gaspi_group_add(group, r));
+	}
+	GASPI_CHECK(gaspi_group_commit(group, GASPI_BLOCK));
+}
+
+static void delete_group(void) {
+	if (my_id < group_size) {
+		GASPI_CHECK(gaspi_group_delete(group));
+	}
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+}
+
+// groups of 1, 2, 4, ... ranks and of all ranks, 0 after the last one
+static gaspi_rank_t next_group_size(const gaspi_rank_t n,
+                                    const gaspi_rank_t num_pes) {
+	if (n == num_pes) {
+		return 0;
+	}
+	return 2 * n < num_pes ? 2 * n : num_pes;
+}
+
+int main(int argc, char* argv[]) {
+	gaspi_rank_t num_pes, n;
+	size_t size;
+	int bo_ret = OPTIONS_OKAY;
+	size_t o;
+	struct measurements_t measurements;
+
+	options.type = COLLECTIVE;
+	options.subtype = SEGMENT;
+	options.name = "gbs_segment";
+
+	bo_ret = benchmark_options(argc, argv);
+
+	switch (bo_ret) {
+		case OPTIONS_BAD_USAGE:
+			print_bad_usage();
+			return EXIT_FAILURE;
+		case OPTIONS_HELP:
+			print_help_message();
+			return EXIT_SUCCESS;
+	}
+
+	GASPI_CHECK(gaspi_proc_init(GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+
+	init_measurements(&measurements);
+
+	print_header(my_id);
+
+	for (n = 1; n != 0; n = next_group_size(n, num_pes)) {
+		create_group(n);
+		for (size = sweep_first(); size != SWEEP_END; size = sweep_next()) {
+			for (o = 0; o < sizeof(operations) / sizeof(*operations); ++o) {
+				if (operations[o].needs_peers && n == 1) {
+					continue;
+				}
+				if (my_id < n) {
+					time_operation(&operations[o], size, &measurements);
+				}
+				print_segment_result(
+				    my_id, measurements, size, n, operations[o].name);
+			}
+		}
+		delete_group();
+	}
+
+	free_measurements(&measurements);
+	GASPI_CHECK(gaspi_proc_term(GASPI_BLOCK));
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,625 @@
+#include <ctype.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "util_raw.h"
+
+/*
+ * Compares two result sets of the suite point by point and exits with 1 if
+ * any point got significantly worse by more than the threshold.
+ *
+ * Either both sets are raw sample files (--raw-file), then the iteration
+ * times are compared with a two-sided Mann-Whitney U test, or both are NDJSON
+ * files (--json), then the medians are compared and the confidence intervals
+ * of --adaptive runs must not overlap. Records without intervals are judged
+ * by the threshold alone.
+ */
+
+#define DEFAULT_THRESHOLD 0.05
+#define DEFAULT_ALPHA 0.05
+#define KEY_LENGTH 512
+#define MAX_MEMBERS 128 // scalar members of one NDJSON record
+
+enum verdict { UNCHANGED = 0, IMPROVEMENT, REGRESSION };
+
+struct series_t {
+	char key[KEY_LENGTH];
+	double* values; // raw samples only
+	int n;
+	int capacity;
+	double median;
+	double ci_low;
+	double ci_high;
+	int has_ci;
+	int higher_is_better;
+	int matched;
+};
+
+struct result_set_t {
+	struct series_t* series;
+	int n;
+	int capacity;
+	int raw;
+};
+
+static double threshold = DEFAULT_THRESHOLD;
+static double alpha = DEFAULT_ALPHA;
+
+static struct series_t* add_series(struct result_set_t* set, const char* key) {
+	struct series_t* s;
+	int i, occurrence = 1;
+
+	// a repeated key, e.g. a sweep over window sizes, gets numbered
+	for (i = 0; i < set->n; ++i) {
+		if (strncmp(set->series[i].key, key, strlen(key)) == 0 &&
+		    (set->series[i].key[strlen(key)] == '\0' ||
+		     set->series[i].key[strlen(key)] == '#')) {
+			++occurrence;
+		}
+	}
+	if (set->n == set->capacity) {
+		set->capacity = set->capacity == 0 ? 64 : 2 * set->capacity;
+		set->series =
+		    realloc(set->series, set->capacity * sizeof(*set->series));
+	}
+	s = &set->series[set->n++];
+	memset(s, 0, sizeof(*s));
+	if (occurrence > 1) {
+		snprintf(s->key, KEY_LENGTH, "%s#%d", key, occurrence);
+	}
+	else {
+		snprintf(s->key, KEY_LENGTH, "%s", key);
+	}
+	return s;
+}
+
+static void add_value(struct series_t* s, const double value) {
+	if (s->n == s->capacity) {
+		s->capacity = s->capacity == 0 ? 1024 : 2 * s->capacity;
+		s->values = realloc(s->values, s->capacity * sizeof(*s->values));
+	}
+	s->values[s->n++] = value;
+}
+
+static int double_cmp(const void* a, const void* b) {
+	const double x = *((const double*) (a));
+	const double y = *((const double*) (b));
+	return (x > y) - (x < y);
+}
+
+/*
+ * Chunks are keyed by benchmark, rank and message size. A chunk whose first
+ * iteration is not 0 continues the previous chunk.
+ */
+static int load_raw(const char* data,
+                    const size_t length,
+                    struct result_set_t* set) {
+	const struct raw_chunk_header_t* chunk;
+	const uint64_t* iteration;
+	const double* duration;
+	struct series_t* s = NULL;
+	char key[KEY_LENGTH];
+	size_t offset, chunk_bytes;
+	uint64_t i;
+	int k;
+
+	offset = sizeof(struct raw_file_header_t);
+	while (offset + sizeof(*chunk) <= length) {
+		chunk = (const struct raw_chunk_header_t*) (data + offset);
+		chunk_bytes = sizeof(*chunk) + chunk->count * (sizeof(uint64_t) +
+		                                               2 * sizeof(double));
+		if (offset + chunk_bytes > length) {
+			fprintf(stderr, "Truncated chunk\n");
+			return 0;
+		}
+		iteration = (const uint64_t*) (chunk + 1);
+		duration = (const double*) (iteration + chunk->count) + chunk->count;
+		if (chunk->count > 0 && (iteration[0] == 0 || s == NULL)) {
+			snprintf(key,
+			         KEY_LENGTH,
+			         "%.*s rank=%u msg_size=%" PRIu64,
+			         RAW_NAME_LENGTH,
+			         chunk->name,
+			         chunk->rank,
+			         chunk->size);
+			s = add_series(set, key);
+		}
+		// warm-up samples are not part of the reported statistics either
+		for (i = chunk->warmup; i < chunk->count; ++i) {
+			add_value(s, duration[i]);
+		}
+		offset += chunk_bytes;
+	}
+	for (k = 0; k < set->n; ++k) {
+		s = &set->series[k];
+		qsort(s->values, s->n, sizeof(*s->values), double_cmp);
+		s->median = s->n % 2 == 0
+		                ? (s->values[s->n / 2 - 1] + s->values[s->n / 2]) / 2
+		                : s->values[s->n / 2];
+	}
+	set->raw = 1;
+	return 1;
+}
+
+/*
+ * Minimal JSON reader for the records of --json. Scalar members are reported
+ * with their dotted path, e.g. options.window_size, arrays are skipped.
+ */
+struct member_t {
+	char path[128];
+	char value[128];
+};
+
+struct record_t {
+	struct member_t members[MAX_MEMBERS];
+	int n;
+	int overflow; // more members than MAX_MEMBERS
+};
+
+static const char* skip_space(const char* c) {
+	while (isspace((unsigned char) *c)) {
+		++c;
+	}
+	return c;
+}
+
+static const char* parse_value(const char* c,
+                               const char* path,
+                               struct record_t* record);
+
+static const char* parse_string(const char* c, char* out, const size_t size) {
+	size_t n = 0;
+
+	if (*c != '"') {
+		return NULL;
+	}
+	for (++c; *c != '"'; ++c) {
+		if (*c == '\0') {
+			return NULL;
+		}
+		if (*c == '\\' && c[1] != '\0') {
+			++c;
+		}
+		if (n + 1 < size) {
+			out[n++] = *c;
+		}
+	}
+	out[n] = '\0';
+	return c + 1;
+}
+
+static const char* parse_object(const char* c,
+                                const char* path,
+                                struct record_t* record) {
+	char key[128], member[128];
+
+	c = skip_space(c + 1);
+	if (*c == '}') {
+		return c + 1;
+	}
+	while (c != NULL) {
+		c = parse_string(skip_space(c), key, sizeof(key));
+		if (c == NULL) {
+			return NULL;
+		}
+		c = skip_space(c);
+		if (*c != ':') {
+			return NULL;
+		}
+		if (*path == '\0') {
+			snprintf(member, sizeof(member), "%s", key);
+		}
+		else if (snprintf(member, sizeof(member), "%s.%s", path, key) >=
+		         (int) sizeof(member)) {
+			return NULL;
+		}
+		c = parse_value(skip_space(c + 1), member, record);
+		if (c == NULL) {
+			return NULL;
+		}
+		c = skip_space(c);
+		if (*c == '}') {
+			return c + 1;
+		}
+		if (*c != ',') {
+			return NULL;
+		}
+		++c;
+	}
+	return NULL;
+}
+
+static const char* parse_value(const char* c,
+                               const char* path,
+                               struct record_t* record) {
+	struct member_t* m;
+	char value[128];
+	size_t n;
+	int depth;
+
+	if (c == NULL) {
+		return NULL;
+	}
+	if (*c == '{') {
+		return parse_object(c, path, record);
+	}
+	if (*c == '[') {
+		for (depth = 0; *c != '\0'; ++c) {
+			if (*c == '"') {
+				c = parse_string(c, value, sizeof(value));
+				if (c == NULL) {
+					return NULL;
+				}
+				--c;
+			}
+			else if (*c == '[') {
+				++depth;
+			}
+			else if (*c == ']' && --depth == 0) {
+				return c + 1;
+			}
+		}
+		return NULL;
+	}
+	if (*c == '"') {
+		c = parse_string(c, value, sizeof(value));
+	}
+	else {
+		for (n = 0; *c != '\0' && *c != ',' && *c != '}' && *c != ']' &&
+		            !isspace((unsigned char) *c);
+		     ++c) {
+			if (n + 1 < sizeof(value)) {
+				value[n++] = *c;
+			}
+		}
+		value[n] = '\0';
+	}
+	if (c != NULL && record->n == MAX_MEMBERS) {
+		record->overflow = 1;
+		return NULL;
+	}
+	if (c != NULL) {
+		m = &record->members[record->n++];
+		snprintf(m->path, sizeof(m->path), "%s", path);
+		snprintf(m->value, sizeof(m->value), "%s", value);
+	}
+	return c;
+}
+
+static int has_prefix(const char* s, const char* prefix) {
+	return strncmp(s, prefix, strlen(prefix)) == 0;
+}
+
+// members that identify a point, every other member is a result
+static int is_identity(const char* path) {
+	const char* const names[] = {"benchmark",
+	                             "memory_mode",
+	                             "msg_size",
+	                             "size",
+	                             "window_size",
+	                             "options.window_size",
+	                             "threads",
+	                             "queues",
+	                             "chunks",
+	                             "cache",
+	                             "delivery",
+	                             "pair",
+	                             "sender",
+	                             "receiver",
+	                             "direction",
+	                             "ranks",
+	                             "segments",
+	                             "operation",
+	                             "numa_node",
+	                             "nic_local"};
+	size_t i;
+
+	for (i = 0; i < sizeof(names) / sizeof(*names); ++i) {
+		if (strcmp(path, names[i]) == 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int load_ndjson(FILE* f, struct result_set_t* set) {
+	struct record_t record;
+	struct series_t* s;
+	char key[KEY_LENGTH], *line = NULL;
+	const char* metric = NULL;
+	size_t capacity = 0, used;
+	double median = NAN;
+	int i, length, line_number = 0;
+
+	while (getline(&line, &capacity, f) > 0) {
+		++line_number;
+		if (*skip_space(line) == '\0') {
+			continue;
+		}
+		record.n = 0;
+		record.overflow = 0;
+		if (*skip_space(line) != '{' ||
+		    parse_value(skip_space(line), "", &record) == NULL) {
+			if (record.overflow) {
+				fprintf(stderr,
+				        "Line %d has more than %d members\n",
+				        line_number,
+				        MAX_MEMBERS);
+			}
+			else {
+				fprintf(stderr,
+				        "Line %d is not a JSON object\n",
+				        line_number);
+			}
+			free(line);
+			return 0;
+		}
+		key[0] = '\0';
+		used = 0;
+		metric = NULL;
+		for (i = 0; i < record.n; ++i) {
+			const char* path = record.members[i].path;
+			if (has_prefix(path, "median_")) {
+				metric = path + strlen("median_");
+				median = atof(record.members[i].value);
+			}
+			if (!is_identity(path)) {
+				continue;
+			}
+			length = snprintf(key + used,
+			                  KEY_LENGTH - used,
+			                  "%s%s=%s",
+			                  used > 0 ? " " : "",
+			                  path,
+			                  record.members[i].value);
+			if (length < 0 || (size_t) length >= KEY_LENGTH - used) {
+				fprintf(stderr,
+				        "Line %d: key of the point exceeds %d bytes\n",
+				        line_number,
+				        KEY_LENGTH - 1);
+				free(line);
+				return 0;
+			}
+			used += length;
+		}
+		if (metric == NULL) {
+			// e.g. the collectives, which report min/max/avg only
+			for (i = 0; i < record.n; ++i) {
+				if (has_prefix(record.members[i].path, "avg_")) {
+					metric = record.members[i].path + strlen("avg_");
+					median = atof(record.members[i].value);
+				}
+			}
+		}
+		if (metric == NULL) {
+			continue;
+		}
+		s = add_series(set, key);
+		s->median = median;
+		s->higher_is_better =
+		    strcmp(metric, "bw") == 0 || strcmp(metric, "rate") == 0;
+		for (i = 0; i < record.n; ++i) {
+			if (has_prefix(record.members[i].path, "ci_low_")) {
+				s->ci_low = atof(record.members[i].value);
+				++s->has_ci;
+			}
+			else if (has_prefix(record.members[i].path, "ci_high_")) {
+				s->ci_high = atof(record.members[i].value);
+				++s->has_ci;
+			}
+		}
+		s->has_ci = s->has_ci == 2;
+	}
+	free(line);
+	return 1;
+}
+
+static int load(const char* path, struct result_set_t* set) {
+	struct stat st;
+	char* data;
+	FILE* f;
+	int fd, ret;
+
+	memset(set, 0, sizeof(*set));
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) < 0) {
+		fprintf(stderr, "Cannot open %s\n", path);
+		return 0;
+	}
+	if ((size_t) st.st_size >= sizeof(struct raw_file_header_t)) {
+		data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED &&
+		    memcmp(data, RAW_MAGIC, sizeof(RAW_MAGIC)) == 0) {
+			close(fd);
+			ret = load_raw(data, st.st_size, set);
+			munmap(data, st.st_size);
+			return ret;
+		}
+		if (data != MAP_FAILED) {
+			munmap(data, st.st_size);
+		}
+	}
+	close(fd);
+	f = fopen(path, "r");
+	if (f == NULL) {
+		fprintf(stderr, "Cannot open %s\n", path);
+		return 0;
+	}
+	ret = load_ndjson(f, set);
+	fclose(f);
+	return ret;
+}
+
+// two-sided p-value, normal approximation with tie and continuity correction
+static double mann_whitney(const struct series_t* a, const struct series_t* b) {
+	const double n1 = a->n, n2 = b->n, n = a->n + b->n;
+	double rank_sum = 0, ties = 0, u, sigma, z, rank;
+	int i = 0, j = 0, k, t, from_a;
+
+	if (a->n == 0 || b->n == 0) {
+		return NAN;
+	}
+	// both sample sets are sorted, merge them and rank ties by their mean
+	while (i < a->n || j < b->n) {
+		const double v = j >= b->n || (i < a->n && a->values[i] <= b->values[j])
+		                     ? a->values[i]
+		                     : b->values[j];
+		from_a = 0;
+		t = 0;
+		while (i < a->n && a->values[i] == v) {
+			++i;
+			++from_a;
+			++t;
+		}
+		while (j < b->n && b->values[j] == v) {
+			++j;
+			++t;
+		}
+		// the tied values occupy the ranks i + j - t + 1 to i + j
+		k = i + j;
+		rank = (2.0 * k - t + 1) / 2.0;
+		rank_sum += from_a * rank;
+		ties += (double) t * t * t - t;
+	}
+	u = rank_sum - n1 * (n1 + 1) / 2;
+	sigma = sqrt(n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1))));
+	if (sigma == 0) {
+		return 1.0;
+	}
+	z = (fabs(u - n1 * n2 / 2) - 0.5) / sigma;
+	return z <= 0 ? 1.0 : erfc(z / sqrt(2.0));
+}
+
+static enum verdict compare(const struct series_t* a,
+                            const struct series_t* b,
+                            const int raw,
+                            double* change,
+                            double* p) {
+	int significant;
+	double worse;
+
+	if (a->median == 0) {
+		// no relative change from zero, any other value is a change
+		*change = b->median == 0 ? 0 : copysign(INFINITY, b->median);
+	}
+	else {
+		*change = (b->median - a->median) / a->median;
+	}
+	*p = NAN;
+	if (raw) {
+		*p = mann_whitney(a, b);
+		significant = *p < alpha;
+	}
+	else if (a->has_ci && b->has_ci) {
+		significant = b->ci_low > a->ci_high || b->ci_high < a->ci_low;
+	}
+	else {
+		significant = 1;
+	}
+	worse = a->higher_is_better ? -*change : *change;
+	if (!significant || fabs(*change) <= threshold) {
+		return UNCHANGED;
+	}
+	return worse > 0 ? REGRESSION : IMPROVEMENT;
+}
+
+static void print_help(const char* name) {
+	fprintf(stdout,
+	        "Usage: %s [-t threshold] [-a alpha] baseline candidate\n\n"
+	        "Compares two raw sample files (--raw-file) or two NDJSON result "
+	        "files (--json)\npoint by point. Exits with 1 if a point got "
+	        "significantly worse by more than\nthe threshold.\n\n"
+	        "\t -t arg\tRelative change that counts as regression. "
+	        "Default %.2f.\n"
+	        "\t -a arg\tSignificance level of the Mann-Whitney U test on raw "
+	        "samples.\n\t\tDefault %.2f. NDJSON results of --adaptive runs "
+	        "are compared by\n\t\tconfidence interval overlap, other NDJSON "
+	        "results by the\n\t\tthreshold alone.\n"
+	        "\t -h\tDisplay this help message.\n",
+	        name,
+	        DEFAULT_THRESHOLD,
+	        DEFAULT_ALPHA);
+}
+
+int main(int argc, char* argv[]) {
+	const char* const verdicts[] = {"unchanged", "improvement", "regression"};
+	struct result_set_t baseline, candidate;
+	struct series_t *a, *b = NULL;
+	enum verdict v;
+	double change, p;
+	int c, i, j, regressions = 0, unmatched = 0;
+
+	while ((c = getopt(argc, argv, "t:a:h")) != -1) {
+		switch (c) {
+			case 't':
+				threshold = atof(optarg);
+				break;
+			case 'a':
+				alpha = atof(optarg);
+				break;
+			case 'h':
+				print_help(argv[0]);
+				return EXIT_SUCCESS;
+			default:
+				print_help(argv[0]);
+				return 2;
+		}
+	}
+	if (argc - optind != 2) {
+		print_help(argv[0]);
+		return 2;
+	}
+	if (!load(argv[optind], &baseline) || !load(argv[optind + 1], &candidate)) {
+		return 2;
+	}
+	if (baseline.raw != candidate.raw) {
+		fprintf(stderr, "Cannot compare raw samples with NDJSON results\n");
+		return 2;
+	}
+
+	fprintf(stdout, "point,baseline,candidate,change,p_value,result\n");
+	for (i = 0; i < baseline.n; ++i) {
+		a = &baseline.series[i];
+		for (j = 0; j < candidate.n; ++j) {
+			b = &candidate.series[j];
+			if (!b->matched && strcmp(a->key, b->key) == 0) {
+				break;
+			}
+		}
+		if (j == candidate.n) {
+			++unmatched;
+			continue;
+		}
+		b->matched = a->matched = 1;
+		v = compare(a, b, baseline.raw, &change, &p);
+		regressions += v == REGRESSION;
+		fprintf(stdout,
+		        "%s,%.4f,%.4f,%.2f%%,",
+		        a->key,
+		        a->median,
+		        b->median,
+		        100 * change);
+		if (isnan(p)) {
+			fprintf(stdout, "n/a,%s\n", verdicts[v]);
+		}
+		else {
+			fprintf(stdout, "%.4g,%s\n", p, verdicts[v]);
+		}
+	}
+	for (j = 0; j < candidate.n; ++j) {
+		unmatched += !candidate.series[j].matched;
+	}
+	if (unmatched > 0) {
+		fprintf(stderr,
+		        "%d points are missing in one of the sets\n",
+		        unmatched);
+	}
+	fprintf(stderr, "%d regressions\n", regressions);
+	return regressions > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,98 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "util_raw.h"
+
+/*
+ * Converts the binary sample files written with --raw-file into CSV, one row
+ * per sample. Several files (e.g. all ranks of a run) can be passed at once.
+ * Samples that --adaptive dropped as warm-up are marked in the last column.
+ */
+
+static int dump_file(const char* path) {
+	const struct raw_file_header_t* header;
+	const struct raw_chunk_header_t* chunk;
+	const uint64_t* iteration;
+	const double *start, *duration;
+	struct stat st;
+	char* data;
+	size_t offset, chunk_bytes;
+	uint64_t i;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) < 0) {
+		fprintf(stderr, "Cannot open %s\n", path);
+		return EXIT_FAILURE;
+	}
+	if ((size_t) st.st_size < sizeof(*header)) {
+		fprintf(stderr, "%s is not a raw sample file\n", path);
+		close(fd);
+		return EXIT_FAILURE;
+	}
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		fprintf(stderr, "Cannot map %s\n", path);
+		return EXIT_FAILURE;
+	}
+
+	header = (const struct raw_file_header_t*) data;
+	if (memcmp(header->magic, RAW_MAGIC, sizeof(header->magic)) != 0 ||
+	    header->version != RAW_VERSION) {
+		fprintf(stderr, "%s is not a raw sample file\n", path);
+		munmap(data, st.st_size);
+		return EXIT_FAILURE;
+	}
+
+	offset = sizeof(*header);
+	while (offset + sizeof(*chunk) <= (size_t) st.st_size) {
+		chunk = (const struct raw_chunk_header_t*) (data + offset);
+		chunk_bytes = sizeof(*chunk) + chunk->count * (sizeof(*iteration) +
+		                                               sizeof(*start) +
+		                                               sizeof(*duration));
+		if (offset + chunk_bytes > (size_t) st.st_size) {
+			fprintf(stderr, "%s: truncated chunk\n", path);
+			break;
+		}
+		iteration = (const uint64_t*) (chunk + 1);
+		start = (const double*) (iteration + chunk->count);
+		duration = start + chunk->count;
+		for (i = 0; i < chunk->count; ++i) {
+			fprintf(stdout,
+			        "%.*s,%u,%" PRIu64 ",%" PRIu64 ",%.0f,%.0f,%d\n",
+			        RAW_NAME_LENGTH,
+			        chunk->name,
+			        chunk->rank,
+			        chunk->size,
+			        iteration[i],
+			        start[i],
+			        duration[i],
+			        i < chunk->warmup);
+		}
+		offset += chunk_bytes;
+	}
+	munmap(data, st.st_size);
+	return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+	int i, ret = EXIT_SUCCESS;
+
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s file.gbsraw [file.gbsraw ...]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	fprintf(stdout,
+	        "benchmark,rank,msg_size,iteration,start_ns,time_ns,warmup\n");
+	for (i = 1; i < argc; ++i) {
+		if (dump_file(argv[i]) != EXIT_SUCCESS) {
+			ret = EXIT_FAILURE;
+		}
+	}
+	return ret;
+}
@@ -5,6 +5,15 @@
 #define DEFAULT_MAX_MESSAGE_SIZE (1ULL << 22)
 #define DEFAULT_PASSIVE_MAX_MESSAGE_SIZE (1ULL << 15)
 #define DEFAULT_ALLREDUCE_MAX_MESSAGE_SIZE 255ULL
+#define DEFAULT_SEGMENT_MIN_MESSAGE_SIZE (1ULL << 12)
+#define DEFAULT_SEGMENT_MAX_MESSAGE_SIZE (1ULL << 30)
+#define DEFAULT_THREADED_MAX_MESSAGE_SIZE (1ULL << 16)
+#define DEFAULT_MAX_THREADS 16
 #define DEFAULT_ITERATIONS 10
 #define DEFAULT_WARMUP_ITERATIONS 10
+#define DEFAULT_CI_WIDTH 0.01
+#define DEFAULT_TIME_BUDGET 1.0
+#define DEFAULT_MAX_ITERATIONS 100000
+// segment used only during setup, e.g. for the clock synchronization
+#define TEMPORARY_SEGMENT_ID 31
 #endif
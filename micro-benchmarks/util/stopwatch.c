@@ -3,12 +3,26 @@
 #include <time.h>
 #include "check.h"
 #include "util.h"
+#include "util_perf.h"
 #include "GASPI.h"
 #include "GASPI_Ext.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define STOPWATCH_HAVE_TSC
+#endif
+
+#define STOPWATCH_CALIBRATION_NS 50000000
+#define STOPWATCH_OVERHEAD_SAMPLES 1000
 
 Timer benchmark_timer;
 gaspi_float cpu_freq;
 double cpu_div;
+double stopwatch_overhead;
+#ifdef STOPWATCH_HAVE_TSC
+static uint64_t tsc_base;
+static double tsc_ns_per_tick;
+#endif
 
 #define stopwatch_secsToNsecs(secs) ((secs) * (uint64_t) 1e9)
 #define stopwatch_secsToNsecs(secs) ((secs) * (uint64_t) 1e9)
@@ -32,6 +46,82 @@ stopwatch_t gaspi_ticks_time(void) {
 	return (stopwatch_t)stopwatch_secsToNsecs(ticks * cpu_div);
 }
 
+#ifdef STOPWATCH_HAVE_TSC
+// the fences keep the measured operations from moving across the read
+static inline uint64_t read_tsc(void) {
+	unsigned int aux;
+	uint64_t tsc;
+
+	_mm_lfence();
+	tsc = __rdtscp(&aux);
+	_mm_lfence();
+	return tsc;
+}
+
+stopwatch_t tsc_gettime(void) {
+	return (stopwatch_t) (read_tsc() - tsc_base) * tsc_ns_per_tick;
+}
+
+static uint64_t raw_ns(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &time);
+	return stopwatch_secsToNsecs(time.tv_sec) + time.tv_nsec;
+}
+
+// constant rate in all P-, C- and T-states: CPUID 0x80000007 EDX bit 8
+static int tsc_invariant(void) {
+	unsigned int eax, ebx, ecx, edx;
+
+	if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 ||
+	    eax < 0x80000007) {
+		return 0;
+	}
+	__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+	return (edx >> 8) & 1;
+}
+
+static int init_tsc(void) {
+	uint64_t ns_start, ns_end, tsc_start, tsc_end;
+
+	if (!tsc_invariant()) {
+		return 0;
+	}
+	ns_start = raw_ns();
+	tsc_start = read_tsc();
+	do {
+		ns_end = raw_ns();
+		tsc_end = read_tsc();
+	} while (ns_end - ns_start < STOPWATCH_CALIBRATION_NS);
+	tsc_ns_per_tick = (double) (ns_end - ns_start) / (tsc_end - tsc_start);
+	tsc_base = tsc_end;
+	return 1;
+}
+#else
+static int init_tsc(void) {
+	return 0;
+}
+#endif
+
+/*
+ * Smallest cost of a stopwatch_start/stopwatch_stop pair. Called once GASPI is
+ * initialized since the GASPI timers may not be used before.
+ */
+void measure_stopwatch_overhead(void) {
+	double t;
+	int i;
+
+	stopwatch_overhead = 0;
+	for (i = 0; i < STOPWATCH_OVERHEAD_SAMPLES; ++i) {
+		t = stopwatch_stop(stopwatch_start());
+		if (i == 0 || t < stopwatch_overhead) {
+			stopwatch_overhead = t;
+		}
+	}
+	if (stopwatch_overhead < 0) {
+		stopwatch_overhead = 0;
+	}
+}
+
 void init_timer(Timer* t) {
 	switch(options.gaspi_timer){
 		case 0:
@@ -43,19 +133,47 @@ void init_timer(Timer* t) {
 		case 2:
 			*t = gaspi_ticks_time;
 			break;
+#ifdef STOPWATCH_HAVE_TSC
+		case 3:
+			*t = tsc_gettime;
+			break;
+#endif
 		default:
 			*t = gbs_gettime;
 			break;
 	}
+	if (options.gaspi_timer == 3 && !init_tsc()) {
+		fprintf(stderr,
+		        "No invariant TSC available, falling back to clock_gettime\n");
+		options.gaspi_timer = 0;
+		*t = gbs_gettime;
+	}
 	GASPI_CHECK(gaspi_cpu_frequency(&cpu_freq));
 	cpu_div = 1 / cpu_freq / (1000.0 * 1000.0);
 }
 
+// the timer in use after init_timer, which may have fallen back
+const char* stopwatch_name(void) {
+	switch (options.gaspi_timer) {
+		case 1:
+			return "gaspi_time_get";
+		case 2:
+			return "gaspi_time_ticks";
+		case 3:
+			return "rdtscp";
+		default:
+			return "clock_gettime";
+	}
+}
+
+// the counters are read outside of the timed region, see util_perf.h
 stopwatch_t stopwatch_start() {
+	perf_start();
 	return benchmark_timer();
 }
 
 stopwatch_t stopwatch_stop(stopwatch_t startTime) {
-	stopwatch_t wtime = stopwatch_start() - startTime;
+	stopwatch_t wtime = benchmark_timer() - startTime;
+	perf_stop();
 	return wtime;
 }
@@ -6,8 +6,12 @@
 typedef double stopwatch_t;
 typedef stopwatch_t (*Timer)(void);
 extern Timer benchmark_timer;
+// cost of an empty measurement in ns, subtracted from every sample
+extern double stopwatch_overhead;
 
 void init_timer(Timer *t);
+void measure_stopwatch_overhead(void);
+const char* stopwatch_name(void);
 stopwatch_t stopwatch_start();
 stopwatch_t stopwatch_stop(stopwatch_t startTime);
 #endif
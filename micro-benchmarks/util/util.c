@@ -3,6 +3,20 @@
 #include "check.h"
 #include "math.h"
 #include "stopwatch.h"
+#include "util_adaptive.h"
+#include "util_delivery.h"
+#include "util_json.h"
+#include "util_memory.h"
+#include "util_offsets.h"
+#include "util_pairs.h"
+#include "util_perf.h"
+#include "util_placement.h"
+#include "util_raw.h"
+#include "util_stats.h"
+#include "util_stripe.h"
+#include "util_sweep.h"
+#include "util_sync.h"
+#include "util_verify.h"
 
 struct benchmark_options_t options;
 struct bad_usage_t bad_usage;
@@ -21,7 +35,37 @@ int benchmark_options(int argc, char* argv[]) {
 	    {"verify", no_argument, 0, 'v'},
 	    {"single-buffer", no_argument, 0, 'b'},
 	    {"timer", required_argument, 0, 't'},
-	    {"warmup-iterations", required_argument, 0, 'u'}};
+	    {"warmup-iterations", required_argument, 0, 'u'},
+	    {"kernels", required_argument, 0, 'k'},
+	    {"list", no_argument, 0, 'l'},
+	    {"streaming", no_argument, 0, 2},
+	    {"raw-file", required_argument, 0, 3},
+	    {"sweep", required_argument, 0, 4},
+	    {"window-sizes", required_argument, 0, 5},
+	    {"adaptive", no_argument, 0, 6},
+	    {"ci-width", required_argument, 0, 7},
+	    {"time-budget", required_argument, 0, 8},
+	    {"max-iterations", required_argument, 0, 9},
+	    {"json", no_argument, 0, 10},
+	    {"counters", required_argument, 0, 11},
+	    {"cpu-list", required_argument, 0, 12},
+	    {"numa-node", required_argument, 0, 13},
+	    {"numa-sweep", no_argument, 0, 14},
+	    {"no-arena", no_argument, 0, 15},
+	    {"hugepages", required_argument, 0, 16},
+	    {"random-offsets", required_argument, 0, 17},
+	    {"threads", required_argument, 0, 18},
+	    {"queues", required_argument, 0, 19},
+	    {"stripe-queues", required_argument, 0, 20},
+	    {"stripe-chunks", required_argument, 0, 21},
+	    {"pairing", required_argument, 0, 22},
+	    {"queue-depth", required_argument, 0, 23},
+	    {"compute-time", required_argument, 0, 24},
+	    {"verify-every", required_argument, 0, 25},
+	    {"cold-cache", required_argument, 0, 26},
+	    {"polling", no_argument, 0, 27},
+	    {"delivery", required_argument, 0, 28},
+	    {0, 0, 0, 0}};
 
 	int option_index = 0;
 	int c;
@@ -31,7 +75,10 @@ int benchmark_options(int argc, char* argv[]) {
 		optstring = "hi:w:s:e:u:vbt:";
 	}
 	else if (options.type == ONESIDED) {
-		optstring = "hi:w:s:e:u:vbt:";
+		if (options.subtype == OVERLAP)
+			optstring = "hi:s:e:u:t:";
+		else
+			optstring = "hi:w:s:e:u:vbt:";
 	}
 	else if (options.type == ATOMIC) {
 		optstring = "hi:u:vt:";
@@ -43,6 +90,9 @@ int benchmark_options(int argc, char* argv[]) {
 		else if (options.subtype == BARRIER) {
 			optstring = "hi:u:t:";
 		}
+		else if (options.subtype == SEGMENT) {
+			optstring = "hi:s:e:u:t:";
+		}
 	}
 	else if (options.type == NOTIFY) {
 		if (options.subtype == RATE)
@@ -50,6 +100,18 @@ int benchmark_options(int argc, char* argv[]) {
 		else
 			optstring = "hi:u:t:";
 	}
+	else if (options.type == DRIVER) {
+		optstring = "hi:w:s:e:u:vbt:k:l";
+	}
+	else if (options.type == THREADED) {
+		optstring = "hi:w:s:e:u:t:";
+	}
+	else if (options.type == MULTIPAIR) {
+		if (options.subtype == BW)
+			optstring = "hi:w:s:e:u:t:";
+		else
+			optstring = "hi:s:e:u:t:";
+	}
 
 	// set default values
 	options.window_size = DEFAULT_WINDOW_SIZE;
@@ -62,15 +124,46 @@ int benchmark_options(int argc, char* argv[]) {
 	else if (options.subtype == ALLREDUCE) {
 		options.max_message_size = DEFAULT_ALLREDUCE_MAX_MESSAGE_SIZE;
 	}
+	else if (options.subtype == SEGMENT) {
+		options.min_message_size = DEFAULT_SEGMENT_MIN_MESSAGE_SIZE;
+		options.max_message_size = DEFAULT_SEGMENT_MAX_MESSAGE_SIZE;
+	}
+	else if (options.type == THREADED) {
+		options.max_message_size = DEFAULT_THREADED_MAX_MESSAGE_SIZE;
+	}
 	else {
 		options.max_message_size = DEFAULT_MAX_MESSAGE_SIZE;
 	}
 	options.skip = DEFAULT_WARMUP_ITERATIONS;
 	options.format = PLAIN;
 	options.verify = 0;
+	options.verify_every = 0;
 	options.single_buffer = 0;
 	options.memory_mode = "multiple_buffer";
 	options.gaspi_timer = 0;
+	options.kernels = "all";
+	options.list_kernels = 0;
+	options.streaming = 0;
+	options.raw_file = NULL;
+	options.adaptive = 0;
+	options.ci_width = DEFAULT_CI_WIDTH;
+	options.time_budget = DEFAULT_TIME_BUDGET;
+	options.max_iterations = DEFAULT_MAX_ITERATIONS;
+	options.cpu_list = NULL;
+	options.numa_node = NULL;
+	options.numa_sweep = 0;
+	options.arena = 1;
+	options.hugepages = NULL;
+	options.offset_span = 0;
+	options.cold_footprint = 0;
+	options.cold_stride = OFFSETS_DEFAULT_STRIDE;
+	options.threads = DEFAULT_MAX_THREADS;
+	options.queues = 0;
+	options.pairing = "block";
+	options.queue_depth = 0;
+	options.compute_time = 0;
+	options.polling = 0;
+	options.delivery = NULL;
 
 	while (1) {
 		c = getopt_long(argc, argv, optstring, long_options, &option_index);
@@ -97,6 +190,174 @@ int benchmark_options(int argc, char* argv[]) {
 			case 1:
 				options.format = RAW_CSV;
 				break;
+			case 2:
+				options.streaming = 1;
+				break;
+			case 3:
+				options.raw_file = optarg;
+				break;
+			case 4:
+				if (sweep_parse(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --sweep mode";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 5:
+				if (sweep_parse_windows(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --window-sizes list";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 6:
+				options.adaptive = 1;
+				break;
+			case 7:
+				options.ci_width = atof(optarg);
+				break;
+			case 8:
+				options.time_budget = atof(optarg);
+				break;
+			case 9:
+				options.max_iterations = atoi(optarg);
+				break;
+			case 10:
+				options.format = NDJSON;
+				break;
+			case 11:
+				if (perf_parse(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --counters list";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 12:
+				if (placement_parse_cpus(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --cpu-list";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				options.cpu_list = optarg;
+				break;
+			case 13:
+				if (placement_parse_node(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --numa-node";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				options.numa_node = optarg;
+				break;
+			case 14:
+				options.numa_sweep = 1;
+				break;
+			case 15:
+				options.arena = 0;
+				break;
+			case 16:
+				if (placement_parse_pages(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --hugepages, use 2M, 1G or "
+					                    "thp";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				options.hugepages = optarg;
+				break;
+			case 17:
+				if (offsets_parse(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --random-offsets span";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 18:
+				options.threads = atoi(optarg);
+				if (options.threads < 1) {
+					bad_usage.message = "--threads needs at least one thread";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 19:
+				options.queues = atoi(optarg);
+				if (options.queues < 0) {
+					bad_usage.message = "Invalid --queues count";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 20:
+				if (stripe_parse_queues(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --stripe-queues list";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 21:
+				if (stripe_parse_chunks(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --stripe-chunks list";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 22:
+				if (pairs_parse(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --pairing, use block, intra, "
+					                    "inter or A:B,C:D,...";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				options.pairing = optarg;
+				break;
+			case 23:
+				options.queue_depth = atoi(optarg);
+				if (options.queue_depth < 1) {
+					bad_usage.message = "Invalid --queue-depth";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 24:
+				options.compute_time = atof(optarg);
+				if (options.compute_time <= 0 || options.subtype != OVERLAP) {
+					bad_usage.message = "Invalid --compute-time";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 25:
+				options.verify_every = atoi(optarg);
+				if (options.verify_every < 1 || !verify_every_enabled()) {
+					bad_usage.message = "Invalid --verify-every";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				options.verify = 1;
+				break;
+			case 26:
+				if (offsets_parse_cold(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --cold-cache footprint";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				break;
+			case 27:
+				if (options.type != ONESIDED || options.subtype != LAT) {
+					bad_usage.message = "--polling is only available for the "
+					                    "one-sided latency benchmarks";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				options.polling = 1;
+				break;
+			case 28:
+				if (delivery_parse(optarg) != OPTIONS_OKAY) {
+					bad_usage.message = "Invalid --delivery list";
+					bad_usage.opt = 0;
+					return OPTIONS_BAD_USAGE;
+				}
+				options.delivery = optarg;
+				break;
 			case 'v':
 				options.verify = 1;
 				break;
@@ -110,18 +371,119 @@ int benchmark_options(int argc, char* argv[]) {
 			case 'u':
 				options.skip = atoi(optarg);
 				break;
+			case 'k':
+				options.kernels = optarg;
+				break;
+			case 'l':
+				options.list_kernels = 1;
+				break;
 			default:
 				bad_usage.message = "Invalid option";
 				bad_usage.opt = optopt;
 				return OPTIONS_BAD_USAGE;
 		}
 	}
+	if (options.streaming && options.format == RAW_CSV) {
+		bad_usage.message = "--raw_csv needs the samples that --streaming "
+		                    "does not keep";
+		bad_usage.opt = 0;
+		return OPTIONS_BAD_USAGE;
+	}
+	if (options.type == MULTIPAIR &&
+	    (options.adaptive || options.format == RAW_CSV)) {
+		bad_usage.message = "--adaptive and --raw_csv are not available "
+		                    "for the multi-pair benchmarks";
+		bad_usage.opt = 0;
+		return OPTIONS_BAD_USAGE;
+	}
+	if (options.adaptive) {
+		if (options.streaming || options.type == COLLECTIVE) {
+			bad_usage.message = "--adaptive needs the samples of a "
+			                    "point-to-point benchmark";
+			bad_usage.opt = 0;
+			return OPTIONS_BAD_USAGE;
+		}
+		// the warm-up ends by itself, -i is the minimum sample count
+		options.skip = 0;
+		if (options.max_iterations < options.iterations) {
+			options.max_iterations = options.iterations;
+		}
+	}
+	if (options.numa_sweep &&
+	    (options.type != DRIVER || options.numa_node != NULL)) {
+		bad_usage.message = "--numa-sweep is a gbs option and replaces "
+		                    "--numa-node";
+		bad_usage.opt = 0;
+		return OPTIONS_BAD_USAGE;
+	}
+	// a list sweep may raise the maximum message size checked below
+	if (sweep_check() != OPTIONS_OKAY) {
+		bad_usage.message = "--window-sizes needs a message size sweep";
+		bad_usage.opt = 0;
+		return OPTIONS_BAD_USAGE;
+	}
+	if (options.offset_span > 0) {
+		if ((options.type != ONESIDED && options.type != DRIVER) ||
+		    options.subtype == OVERLAP) {
+			bad_usage.message = "--random-offsets is only available for the "
+			                    "one-sided benchmarks";
+			bad_usage.opt = 0;
+			return OPTIONS_BAD_USAGE;
+		}
+		if (options.offset_span < options.max_message_size) {
+			bad_usage.message = "--random-offsets span is smaller than the "
+			                    "maximum message size";
+			bad_usage.opt = 0;
+			return OPTIONS_BAD_USAGE;
+		}
+		if (options.verify) {
+			bad_usage.message = "--verify expects the messages at their "
+			                    "fixed offsets, not --random-offsets";
+			bad_usage.opt = 0;
+			return OPTIONS_BAD_USAGE;
+		}
+	}
+	if (options.cold_footprint > 0) {
+		if ((options.type != ONESIDED && options.type != DRIVER) ||
+		    options.subtype == OVERLAP || options.offset_span > 0) {
+			bad_usage.message = "--cold-cache is only available for the "
+			                    "one-sided benchmarks, without "
+			                    "--random-offsets";
+			bad_usage.opt = 0;
+			return OPTIONS_BAD_USAGE;
+		}
+		if (options.cold_footprint < options.max_message_size) {
+			bad_usage.message = "--cold-cache footprint is smaller than the "
+			                    "maximum message size";
+			bad_usage.opt = 0;
+			return OPTIONS_BAD_USAGE;
+		}
+		if (options.verify) {
+			bad_usage.message = "--verify expects the messages at their "
+			                    "fixed offsets, not --cold-cache";
+			bad_usage.opt = 0;
+			return OPTIONS_BAD_USAGE;
+		}
+	}
+	if (stripe_check() != OPTIONS_OKAY) {
+		bad_usage.message = "Striping and --queue-depth are only available "
+		                    "for the one-sided bandwidth benchmarks";
+		bad_usage.opt = 0;
+		return OPTIONS_BAD_USAGE;
+	}
 	init_timer(&benchmark_timer);
+	perf_open();
 	return OPTIONS_OKAY;
 }
 
 void print_bad_usage() {
-	fprintf(stderr, "%s [-%c]\n\n", bad_usage.message, (char) bad_usage.opt);
+	if (bad_usage.opt == 0) {
+		fprintf(stderr, "%s\n\n", bad_usage.message);
+	}
+	else {
+		fprintf(
+		    stderr, "%s [-%c]\n\n", bad_usage.message, (char) bad_usage.opt);
+	}
 	fflush(stderr);
 }
 
@@ -131,18 +493,31 @@ void print_help_message() {
 	fprintf(stdout, "\n");
 	fprintf(stdout, "\t -h [--help]\tDisplay this help message.\n");
 
-	if (options.subtype != BARRIER && options.type != ATOMIC &&
-	    options.type != NOTIFY) {
+	if (options.subtype == SEGMENT) {
 		fprintf(stdout,
-		        "\t -w [--window_size] arg\tNumber of messages sent per "
-		        "iteration. Default 64.\n");
+		        "\t -s [--min_message_size] arg\t Minimum segment size. "
+		        "Default 4 KiB.\n");
+		fprintf(stdout,
+		        "\t -e [--max_message_size] arg\t Maximum segment size. "
+		        "Default 1 GiB.\n");
+	}
+	else if (options.subtype != BARRIER && options.type != ATOMIC &&
+	         options.type != NOTIFY) {
+		if ((options.type != MULTIPAIR || options.subtype == BW) &&
+		    options.subtype != OVERLAP) {
+			fprintf(stdout,
+			        "\t -w [--window_size] arg\tNumber of messages sent "
+			        "per iteration. Default 64.\n");
+		}
 		fprintf(stdout,
 		        "\t -s [--min_message_size] arg\t Minimum message size. "
 		        "Default 1 byte.\n");
 		fprintf(stdout,
 		        "\t -e [--max_message_size] arg\t Maximum message size. "
-		        "Default (1 << 22) byte.\n");
-		if (options.subtype != LAT) {
+		        "Default (1 << %d) byte.\n",
+		        options.type == THREADED ? 16 : 22);
+		if (options.subtype != LAT && options.subtype != OVERLAP &&
+		    options.type != THREADED && options.type != MULTIPAIR) {
 			fprintf(stdout,
 			        "\t -b [--single-buffer]\tUse a single memory allocation "
 			        "for the measurements.\n");
@@ -153,10 +528,17 @@ void print_help_message() {
 		        "\t -w [--window_size] arg\tNumber of messages sent per "
 		        "iteration. Default 64.\n");
 	}
-	if (options.subtype != BARRIER && options.subtype != NOTIFY) {
+	if (options.subtype != BARRIER && options.subtype != NOTIFY &&
+	    options.subtype != SEGMENT && options.subtype != OVERLAP &&
+	    options.type != THREADED && options.type != MULTIPAIR) {
 		fprintf(stdout,
 		        "\t -v [--verify]\tCheck results of the performed "
 		        "operation.\n");
+		if (verify_every_enabled()) {
+			fprintf(stdout,
+			        "\t --verify-every N\tAlso check every N-th iteration "
+			        "with a new payload\n\t\tpattern, implies --verify.\n");
+		}
 	}
 	fprintf(stdout,
 	        "\t -i [--iterations] arg\tNumber of iterations. Default 10.\n");
@@ -166,19 +548,146 @@ void print_help_message() {
 	fprintf(stdout, "\t --csv\tPrint output in csv format with statistics.\n");
 	fprintf(stdout,
 	        "\t --raw_csv\tPrint the collected raw data without statistics.\n");
+	fprintf(stdout,
+	        "\t --json\tPrint one JSON object per result and line, including "
+	        "the options,\n\t\thosts, GASPI limits and timer of the run.\n");
+	fprintf(stdout,
+	        "\t --streaming\tDo not store the samples, compute the statistics "
+	        "and percentiles\n\t\ton the fly in constant memory.\n");
+	fprintf(stdout,
+	        "\t --raw-file prefix\tWrite every sample to the binary file "
+	        "prefix.<rank>.gbsraw.\n");
+	if (options.subtype != BARRIER && options.type != ATOMIC &&
+	    options.type != NOTIFY) {
+		fprintf(stdout,
+		        "\t --sweep mode\tMessage sizes to measure: pow2 (default), "
+		        "linear:STEP, log:N\n\t\t(N sizes per octave), list:A,B,... "
+		        "or adaptive[:T] (refine where\n\t\tthe result deviates by "
+		        "more than T from its neighbors' trend).\n");
+		if (options.subtype != OVERLAP) {
+			fprintf(stdout,
+			        "\t --window-sizes A,B,...\tRepeat the sweep for every "
+			        "window size.\n");
+		}
+	}
+	if (options.type != COLLECTIVE && options.type != MULTIPAIR) {
+		fprintf(stdout,
+		        "\t --adaptive\tIterate until the 95%% bootstrap confidence "
+		        "interval of the\n\t\tmedian is narrower than --ci-width "
+		        "(default 0.01, relative),\n\t\tthe --time-budget (default "
+		        "1 s per size) is spent or\n\t\t--max-iterations (default "
+		        "100000) are done. The warm-up\n\t\tends once the samples "
+		        "are stable, -i sets the minimum.\n");
+	}
+	fprintf(stdout,
+	        "\t --counters A,B,...\tMean event counts per timed iteration "
+	        "of cycles,\n\t\tinstructions, cache-misses, dtlb-misses, "
+	        "page-faults and\n\t\tcontext-switches (perf_event_open).\n");
 	fprintf(stdout,
 	        "\t -t [--timer] arg\t 0: clock_gettime | 1: gaspi_time_get | 2: "
-	        "gaspi_time_ticks.\n");
+	        "gaspi_time_ticks | 3: rdtscp.\n");
+	if (options.type != COLLECTIVE) {
+		fprintf(stdout,
+		        "\t --no-arena\tCreate and delete the segments for every "
+		        "message size instead\n\t\tof registering the largest "
+		        "footprint once.\n");
+	}
+	fprintf(stdout,
+	        "\t --cpu-list A:B:...\tPin the ranks round-robin to the "
+	        "groups of cores A, B, ...,\n\t\te.g. 0-3:16-19.\n");
+	if (options.type != COLLECTIVE) {
+		fprintf(stdout,
+		        "\t --numa-node arg\tPlace the segments on a NUMA node: "
+		        "N, nic (the node of the\n\t\tInfiniBand device) or remote "
+		        "(another node).\n");
+		fprintf(stdout,
+		        "\t --hugepages arg\tBack the segments with 2M or 1G huge "
+		        "pages or with\n\t\ttransparent huge pages (thp).\n");
+	}
+	if (options.subtype == OVERLAP) {
+		fprintf(stdout,
+		        "\t --compute-time us\tDuration of the compute kernel. "
+		        "Default the time of the\n\t\tcommunication alone.\n");
+	}
+	if ((options.type == ONESIDED || options.type == DRIVER) &&
+	    options.subtype != OVERLAP) {
+		fprintf(stdout,
+		        "\t --random-offsets span\tSpread the messages over "
+		        "uniformly random offsets,\n\t\taligned to the message "
+		        "size, in segments of span bytes\n\t\t(K, M and G "
+		        "suffixes are accepted).\n");
+		fprintf(stdout,
+		        "\t --cold-cache footprint[:stride]\tMeasure every size "
+		        "hot and then cold,\n\t\trotating the messages through "
+		        "footprint bytes at stride-aligned\n\t\toffsets "
+		        "(default 4K) so that no message finds a warm line.\n");
+	}
+	if (options.type == ONESIDED && options.subtype == BW) {
+		fprintf(stdout,
+		        "\t --stripe-queues A,B,...\tSpread the chunks of every "
+		        "message round-robin\n\t\tover the first A, B, ... "
+		        "queues.\n");
+		fprintf(stdout,
+		        "\t --stripe-chunks A,B,...\tSplit every message into A, "
+		        "B, ... chunks.\n");
+		fprintf(stdout,
+		        "\t --queue-depth arg\tKeep at most arg requests in every "
+		        "queue, completing them\n\t\twith gaspi_wait(GASPI_TEST) "
+		        "instead of waiting after\n\t\tevery window.\n");
+	}
+	if (options.type == ONESIDED && options.subtype == LAT) {
+		fprintf(stdout,
+		        "\t --polling\tSpin on gaspi_wait and gaspi_notify_waitsome "
+		        "with\n\t\tGASPI_TEST instead of blocking.\n");
+	}
+	if (delivery_enabled()) {
+		fprintf(stdout,
+		        "\t --delivery A,B\tMeasure every size for each way to "
+		        "detect the arrival:\n\t\tnotify (gaspi_notify_waitsome, "
+		        "default) or poll (spin\n\t\ton the last byte of the "
+		        "payload).\n");
+	}
+	if (options.type == THREADED) {
+		fprintf(stdout,
+		        "\t --threads arg\tMaximum number of threads posting on "
+		        "rank 0, measured for\n\t\t1, 2, 4, ... threads. "
+		        "Default 16.\n");
+		fprintf(stdout,
+		        "\t --queues arg\tNumber of queues the threads share "
+		        "round-robin. Default 0,\n\t\ta queue per thread.\n");
+	}
+	if (options.type == MULTIPAIR) {
+		fprintf(stdout,
+		        "\t --pairing mode\tPairs of communicating ranks: block "
+		        "(rank i with\n\t\ti + n / 2, default), intra (within the "
+		        "nodes), inter (across\n\t\tneighboring nodes) or "
+		        "A:B,C:D,... (A sends).\n");
+	}
+	if (options.type == DRIVER) {
+		fprintf(stdout,
+		        "\t --numa-sweep\tRun every kernel with the segments on the "
+		        "NIC's node and on\n\t\tanother node.\n");
+		fprintf(stdout,
+		        "\t -k [--kernels] arg\tComma separated list of kernels to "
+		        "run. Default all.\n");
+		fprintf(stdout, "\t -l [--list]\tList the available kernels.\n");
+	}
 	fprintf(stdout, "\n\n");
 	fflush(stdout);
 }
 
+static void print_pair_header(void);
+
 void print_header(const gaspi_rank_t id) {
+	if (options.format == NDJSON) {
+		json_collect_metadata();
+		return;
+	}
 	if (id == 0) {
 		if (options.type == ATOMIC) {
 			if (options.format == PLAIN) {
 				fprintf(stdout,
-				        "%-*s%*s%*s%*s%*s%*s%*s\n",
+				        "%-*s%*s%*s%*s%*s%*s%*s",
 				        10,
 				        "#iterations",
 				        FIELD_WIDTH,
@@ -193,12 +702,14 @@ void print_header(const gaspi_rank_t id) {
 				        "var_lat",
 				        FIELD_WIDTH,
 				        "std_lat");
+				print_percentile_header("lat");
 			}
 			else if (options.format == CSV) {
 				fprintf(stdout,
 				        "#iterations,min_lat,max_lat,avg_lat,median_"
 				        "lat,var_lat,"
-				        "std_lat\n");
+				        "std_lat");
+				print_percentile_header("lat");
 			}
 			else if (options.format == RAW_CSV) {
 				fprintf(stdout, "old,new,count,lat\n");
@@ -208,7 +719,7 @@ void print_header(const gaspi_rank_t id) {
 			if (options.subtype == RATE) {
 				if (options.format == PLAIN) {
 					fprintf(stdout,
-					        "%-*s%*s%*s%*s%*s%*s\n",
+					        "%-*s%*s%*s%*s%*s%*s",
 					        10,
 					        "min_rate",
 					        FIELD_WIDTH,
@@ -221,11 +732,13 @@ void print_header(const gaspi_rank_t id) {
 					        "var_rate",
 					        FIELD_WIDTH,
 					        "std_rate");
+					print_percentile_header("rate");
 				}
 				else if (options.format == CSV) {
 					fprintf(stdout,
 					        "min_rate,max_rate,avg_"
-					        "rate,median_rate,var_rate,std_rate\n");
+					        "rate,median_rate,var_rate,std_rate");
+					print_percentile_header("rate");
 				}
 				else if (options.format == RAW_CSV) {
 					fprintf(stdout, "count,lat\n");
@@ -234,7 +747,7 @@ void print_header(const gaspi_rank_t id) {
 			else if (options.subtype == PINGPONG) {
 				if (options.format == PLAIN) {
 					fprintf(stdout,
-					        "%-*s%*s%*s%*s%*s%*s\n",
+					        "%-*s%*s%*s%*s%*s%*s",
 					        10,
 					        "min_lat",
 					        FIELD_WIDTH,
@@ -247,21 +760,138 @@ void print_header(const gaspi_rank_t id) {
 					        "var_lat",
 					        FIELD_WIDTH,
 					        "std_lat");
+					print_percentile_header("lat");
 				}
 				else if (options.format == CSV) {
 					fprintf(stdout,
 					        "min_lat,max_lat,avg_"
-					        "lat,median_lat,var_lat,std_lat\n");
+					        "lat,median_lat,var_lat,std_lat");
+					print_percentile_header("lat");
 				}
 				else if (options.format == RAW_CSV) {
 					fprintf(stdout, "count,lat\n");
 				}
 			}
 		}
+		else if (options.type == THREADED) {
+			if (options.format == PLAIN) {
+				fprintf(stdout,
+				        "%-*s%*s%*s%*s%*s%*s%*s%*s%*s%*s",
+				        10,
+				        "threads",
+				        FIELD_WIDTH,
+				        "queues",
+				        FIELD_WIDTH,
+				        "msg_size",
+				        FIELD_WIDTH,
+				        "min_bw",
+				        FIELD_WIDTH,
+				        "max_bw",
+				        FIELD_WIDTH,
+				        "avg_bw",
+				        FIELD_WIDTH,
+				        "median_bw",
+				        FIELD_WIDTH,
+				        "var_bw",
+				        FIELD_WIDTH,
+				        "std_bw",
+				        FIELD_WIDTH,
+				        "msg_rate");
+				print_percentile_header("bw");
+			}
+			else if (options.format == CSV) {
+				fprintf(stdout,
+				        "threads,queues,msg_size,min_bw,max_bw,avg_bw,median_"
+				        "bw,var_bw,std_bw,msg_rate");
+				print_percentile_header("bw");
+			}
+			else if (options.format == RAW_CSV) {
+				fprintf(stdout, "threads,queues,msg_size,count,bw\n");
+			}
+		}
+		else if (options.type == MULTIPAIR) {
+			print_pair_header();
+		}
+		else if (options.subtype == OVERLAP) {
+			if (options.format == PLAIN) {
+				fprintf(stdout,
+				        "%-*s%*s%*s%*s%*s%*s%*s%*s%*s%*s%*s",
+				        10,
+				        "msg_size",
+				        FIELD_WIDTH,
+				        "comm_lat",
+				        FIELD_WIDTH,
+				        "compute_lat",
+				        FIELD_WIDTH,
+				        "min_lat",
+				        FIELD_WIDTH,
+				        "max_lat",
+				        FIELD_WIDTH,
+				        "avg_lat",
+				        FIELD_WIDTH,
+				        "median_lat",
+				        FIELD_WIDTH,
+				        "var_lat",
+				        FIELD_WIDTH,
+				        "std_lat",
+				        FIELD_WIDTH,
+				        "overlap",
+				        FIELD_WIDTH,
+				        "progress");
+				print_percentile_header("lat");
+			}
+			else if (options.format == CSV) {
+				fprintf(stdout,
+				        "msg_size,comm_lat,compute_lat,min_lat,max_lat,avg_"
+				        "lat,median_lat,var_lat,std_lat,overlap,progress");
+				print_percentile_header("lat");
+			}
+			else if (options.format == RAW_CSV) {
+				fprintf(stdout, "msg_size,count,lat\n");
+			}
+		}
+		else if (options.subtype == ONEWAY) {
+			if (options.format == PLAIN) {
+				fprintf(stdout,
+				        "%-*s%*s%*s%*s%*s%*s%*s%*s%*s%*s%*s",
+				        10,
+				        "memory_mode",
+				        FIELD_WIDTH,
+				        "msg_size",
+				        FIELD_WIDTH,
+				        "direction",
+				        FIELD_WIDTH,
+				        "min_lat",
+				        FIELD_WIDTH,
+				        "max_lat",
+				        FIELD_WIDTH,
+				        "avg_lat",
+				        FIELD_WIDTH,
+				        "median_lat",
+				        FIELD_WIDTH,
+				        "var_lat",
+				        FIELD_WIDTH,
+				        "std_lat",
+				        FIELD_WIDTH,
+				        "asym_lat",
+				        FIELD_WIDTH,
+				        "clock_err");
+				print_percentile_header("lat");
+			}
+			else if (options.format == CSV) {
+				fprintf(stdout,
+				        "memory_mode,msg_size,direction,min_lat,max_lat,avg_"
+				        "lat,median_lat,var_lat,std_lat,asym_lat,clock_err");
+				print_percentile_header("lat");
+			}
+			else if (options.format == RAW_CSV) {
+				fprintf(stdout, "msg_size,direction,count,lat\n");
+			}
+		}
 		else if (options.subtype == LAT) {
-			if (options.format == PLAIN)
+			if (options.format == PLAIN) {
 				fprintf(stdout,
-				        "%-*s%*s%*s%*s%*s%*s%*s%*s\n",
+				        "%-*s%*s%*s%*s%*s%*s%*s%*s",
 				        10,
 				        "memory_mode",
 				        FIELD_WIDTH,
@@ -278,19 +908,23 @@ void print_header(const gaspi_rank_t id) {
 				        "var_lat",
 				        FIELD_WIDTH,
 				        "std_lat");
-			else if (options.format == CSV)
+				print_percentile_header("lat");
+			}
+			else if (options.format == CSV) {
 				fprintf(stdout,
 				        "memory_mode,msg_size,min_lat,max_lat,avg_lat,median_"
 				        "lat,var_lat,"
-				        "std_lat\n");
+				        "std_lat");
+				print_percentile_header("lat");
+			}
 			else if (options.format == RAW_CSV) {
 				fprintf(stdout, "msg_size,count,lat\n");
 			}
 		}
 		else if (options.subtype == BW) {
-			if (options.format == PLAIN)
+			if (options.format == PLAIN) {
 				fprintf(stdout,
-				        "%-*s%*s%*s%*s%*s%*s%*s%*s\n",
+				        "%-*s%*s%*s%*s%*s%*s%*s%*s",
 				        10,
 				        "memory_mode",
 				        FIELD_WIDTH,
@@ -307,10 +941,14 @@ void print_header(const gaspi_rank_t id) {
 				        "var_bw",
 				        FIELD_WIDTH,
 				        "std_bw");
-			else if (options.format == CSV)
+				print_percentile_header("bw");
+			}
+			else if (options.format == CSV) {
 				fprintf(stdout,
 				        "memory_mode,msg_size,min_bw,max_bw,avg_bw,median_bw,"
-				        "var_bw,std_bw\n");
+				        "var_bw,std_bw");
+				print_percentile_header("bw");
+			}
 			else if (options.format == RAW_CSV) {
 				fprintf(stdout, "msg_size,count,bw\n");
 			}
@@ -355,10 +993,44 @@ void print_header(const gaspi_rank_t id) {
 			else if (options.format == CSV)
 				fprintf(stdout, "ranks,iterations,min_lat,max_lat,avg_lat\n");
 		}
+		else if (options.subtype == SEGMENT) {
+			if (options.format == PLAIN) {
+				fprintf(stdout,
+				        "%-*s%*s%*s%*s%*s%*s%*s%*s%*s",
+				        10,
+				        "size",
+				        FIELD_WIDTH,
+				        "ranks",
+				        FIELD_WIDTH,
+				        "operation",
+				        FIELD_WIDTH,
+				        "min_lat",
+				        FIELD_WIDTH,
+				        "max_lat",
+				        FIELD_WIDTH,
+				        "avg_lat",
+				        FIELD_WIDTH,
+				        "median_lat",
+				        FIELD_WIDTH,
+				        "var_lat",
+				        FIELD_WIDTH,
+				        "std_lat");
+				print_percentile_header("lat");
+			}
+			else if (options.format == CSV) {
+				fprintf(stdout,
+				        "size,ranks,operation,min_lat,max_lat,avg_lat,median_"
+				        "lat,var_lat,std_lat");
+				print_percentile_header("lat");
+			}
+			else if (options.format == RAW_CSV) {
+				fprintf(stdout, "size,ranks,operation,count,lat\n");
+			}
+		}
 		else if (options.subtype == STRIDED) {
-			if (options.format == PLAIN)
+			if (options.format == PLAIN) {
 				fprintf(stdout,
-				        "%-*s%*s%*s%*s%*s%*s%*s%*s\n",
+				        "%-*s%*s%*s%*s%*s%*s%*s%*s",
 				        10,
 				        "#segments",
 				        FIELD_WIDTH,
@@ -375,47 +1047,209 @@ void print_header(const gaspi_rank_t id) {
 				        "var_lat",
 				        FIELD_WIDTH,
 				        "std_lat");
-			else if (options.format == CSV)
+				print_percentile_header("lat");
+			}
+			else if (options.format == CSV) {
 				fprintf(stdout,
 				        "#segments,#iterations,min_lat,max_lat,avg_lat,median_"
-				        "lat,var_lat,std_lat\n");
+				        "lat,var_lat,std_lat");
+				print_percentile_header("lat");
+			}
 		}
 		fflush(stdout);
 	}
 }
 
 static int double_cmp(const void* a, const void* b) {
-	return *((const double*) (a)) > *((const double*) (b));
+	const double x = *((const double*) (a));
+	const double y = *((const double*) (b));
+	return (x > y) - (x < y);
 }
 
-void compute_statistics(struct measurements_t measurements,
-                        struct statistics_t* statistics,
-                        const size_t size) {
-	int n, i;
-	double sum = 0;
-	double* t;
+void init_measurements(struct measurements_t* measurements) {
+	placement_init();
+	stripe_init();
+	measure_stopwatch_overhead();
+	measurements->n = options.iterations;
+	if (options.streaming) {
+		measurements->time = NULL;
+		measurements->stream = malloc(sizeof(struct stream_statistics_t));
+		stream_statistics_reset(measurements->stream);
+	}
+	else if (options.adaptive) {
+		measurements->time = malloc(options.max_iterations * sizeof(double));
+		measurements->stream = NULL;
+	}
+	else {
+		measurements->time = malloc(options.iterations * sizeof(double));
+		measurements->stream = NULL;
+	}
+}
 
-	n = measurements.n;
-	t = measurements.time;
+// the timer overhead is part of every measurement
+static double subtract_overhead(const double measured) {
+	return measured > stopwatch_overhead ? measured - stopwatch_overhead : 0;
+}
+
+static void record_time(struct measurements_t* measurements,
+                        const int i,
+                        const double start,
+                        const double time) {
+	raw_sink_add(i, start, time);
+	if (options.adaptive) {
+		// measure_continue may drop warm-up samples, always append
+		measurements->time[measurements->n++] = time;
+		return;
+	}
+	if (measurements->stream == NULL) {
+		measurements->time[i] = time;
+		return;
+	}
+	if (i == 0) {
+		stream_statistics_reset(measurements->stream);
+	}
+	stream_statistics_add(measurements->stream, time);
+}
+
+// i is the index of the measured iteration, index 0 starts a new sample set
+void record_measurement(struct measurements_t* measurements,
+                        const int i,
+                        const double start,
+                        const double measured) {
+	record_time(measurements, i, start, subtract_overhead(measured));
+}
+
+// records half of a timed round trip, the timer overhead was paid once
+void record_round_trip(struct measurements_t* measurements,
+                       const int i,
+                       const double start,
+                       const double measured) {
+	record_time(measurements, i, start, subtract_overhead(measured) / 2);
+}
+
+void free_measurements(struct measurements_t* measurements) {
+	free(measurements->time);
+	free(measurements->stream);
+	raw_sink_close();
+}
 
+/*
+ * Bandwidth and rate are inversely proportional to the iteration time:
+ * value = scale / t. Latencies are proportional: value = scale * t.
+ */
+static int inverse_metric(void) {
+	return options.subtype == BW ||
+	       (options.type == NOTIFY && options.subtype == RATE);
+}
+
+static double metric_scale(const size_t size) {
 	if (options.subtype == BW) {
-		for (i = 0; i < n; ++i) {
-			t[i] = (double) size / t[i];
-			t[i] *= 1e3; // MB/s
-		}
+		return (double) size * 1e3; // MB/s
 	}
 	else if (options.type == NOTIFY && options.subtype == RATE) {
-		for (i = 0; i < n; ++i) {
-			t[i] = options.window_size / (t[i] * 1e-9);
-		}
+		return options.window_size * 1e9;
 	}
 	else if (options.subtype == LAT || options.type == COLLECTIVE ||
-	         options.subtype == PINGPONG || options.subtype == STRIDED) {
-		for (i = 0; i < n; ++i) {
-			t[i] *= 1e-3; // ns to us
+	         options.subtype == PINGPONG || options.subtype == STRIDED ||
+	         options.subtype == ONEWAY || options.subtype == OVERLAP) {
+		return 1e-3; // ns to us
+	}
+	return 1.0;
+}
+
+static double convert_time(const double t, const double scale) {
+	return inverse_metric() ? scale / t : scale * t;
+}
+
+static const char* metric_name(void) {
+	if (options.subtype == BW) {
+		return "bw";
+	}
+	else if (options.type == NOTIFY && options.subtype == RATE) {
+		return "rate";
+	}
+	return "lat";
+}
+
+// nearest rank percentile of sorted values, p in [0, 1]
+static double sorted_percentile(const double* t, const int n, const double p) {
+	int rank = (int) ceil(p * n);
+	if (rank < 1) {
+		rank = 1;
+	}
+	if (rank > n) {
+		rank = n;
+	}
+	return t[rank - 1];
+}
+
+/*
+ * Percentiles always refer to the iteration time, i.e. p99 is the slow tail
+ * for latencies as well as for bandwidths and rates.
+ */
+static double tail_percentile(const double* t, const int n, const double p) {
+	return sorted_percentile(t, n, inverse_metric() ? 1.0 - p : p);
+}
+
+static void compute_stream_statistics(const struct stream_statistics_t* s,
+                                      struct statistics_t* statistics,
+                                      const double scale) {
+	const struct histogram_t* h = &s->histogram;
+
+	if (inverse_metric()) {
+		statistics->min = scale / s->max;
+		statistics->max = scale / s->min;
+		statistics->avg = scale * s->inverse.mean;
+		statistics->var = scale * scale * welford_variance(&s->inverse);
+	}
+	else {
+		statistics->min = scale * s->min;
+		statistics->max = scale * s->max;
+		statistics->avg = scale * s->time.mean;
+		statistics->var = scale * scale * welford_variance(&s->time);
+	}
+	statistics->std = sqrt(statistics->var);
+	statistics->median = convert_time(histogram_percentile(h, 0.5), scale);
+	statistics->p90 = convert_time(histogram_percentile(h, 0.9), scale);
+	statistics->p99 = convert_time(histogram_percentile(h, 0.99), scale);
+	statistics->p999 = convert_time(histogram_percentile(h, 0.999), scale);
+	statistics->p9999 = convert_time(histogram_percentile(h, 0.9999), scale);
+}
+
+void compute_statistics(struct measurements_t measurements,
+                        struct statistics_t* statistics,
+                        const size_t size) {
+	int n, i;
+	double sum = 0, low, high;
+	double* t;
+	const double scale = metric_scale(size);
+
+	statistics->samples = measurements.n;
+	perf_means(statistics->counters);
+	if (measurements.stream != NULL) {
+		compute_stream_statistics(measurements.stream, statistics, scale);
+		return;
+	}
+	if (options.adaptive) {
+		bootstrap_median_ci(measurements.time, measurements.n, &low, &high);
+		// the slow end of the interval is the low end for inverse metrics
+		if (inverse_metric()) {
+			statistics->ci_low = convert_time(high, scale);
+			statistics->ci_high = convert_time(low, scale);
+		}
+		else {
+			statistics->ci_low = convert_time(low, scale);
+			statistics->ci_high = convert_time(high, scale);
 		}
 	}
 
+	// work on a copy, the samples stay untouched for the raw output
+	n = measurements.n;
+	t = malloc(n * sizeof(*t));
+	for (i = 0; i < n; ++i) {
+		t[i] = convert_time(measurements.time[i], scale);
+	}
+
 	qsort(t, n, sizeof *t, double_cmp);
 
 	statistics->min = t[0];
@@ -426,7 +1260,16 @@ void compute_statistics(struct measurements_t measurements,
 	}
 
 	statistics->avg = sum / n;
-	statistics->median = t[n / 2];
+	if (n % 2 == 0) {
+		statistics->median = (t[n / 2 - 1] + t[n / 2]) / 2.0;
+	}
+	else {
+		statistics->median = t[n / 2];
+	}
+	statistics->p90 = tail_percentile(t, n, 0.9);
+	statistics->p99 = tail_percentile(t, n, 0.99);
+	statistics->p999 = tail_percentile(t, n, 0.999);
+	statistics->p9999 = tail_percentile(t, n, 0.9999);
 
 	sum = 0;
 
@@ -436,6 +1279,209 @@ void compute_statistics(struct measurements_t measurements,
 
 	statistics->var = sum / n;
 	statistics->std = sqrt(statistics->var);
+	free(t);
+}
+
+static void print_column_header(const char* column) {
+	if (options.format == PLAIN) {
+		fprintf(stdout, "%*s", FIELD_WIDTH, column);
+	}
+	else {
+		fprintf(stdout, ",%s", column);
+	}
+}
+
+void print_percentile_header(const char* metric) {
+	const char* const percentiles[] = {"p90", "p99", "p99.9", "p99.99"};
+	char column[FIELD_WIDTH];
+	int i;
+
+	for (i = 0; i < 4; ++i) {
+		snprintf(column, sizeof(column), "%s_%s", percentiles[i], metric);
+		print_column_header(column);
+	}
+	if (options.adaptive) {
+		snprintf(column, sizeof(column), "ci_low_%s", metric);
+		print_column_header(column);
+		snprintf(column, sizeof(column), "ci_high_%s", metric);
+		print_column_header(column);
+		print_column_header("samples");
+	}
+	for (i = 0; i < perf_num_counters(); ++i) {
+		print_column_header(perf_counter_name(i));
+	}
+	if (placement_node() != PLACEMENT_ANY) {
+		print_column_header("numa_node");
+		print_column_header("nic_local");
+	}
+	if (sweep_windows()) {
+		print_column_header("window_size");
+	}
+	if (stripe_active()) {
+		print_column_header("queues");
+		print_column_header("chunks");
+	}
+	if (offsets_configs() > 1) {
+		print_column_header("cache");
+	}
+	if (delivery_active()) {
+		print_column_header("delivery");
+	}
+	if (pair_sync_enabled()) {
+		print_column_header("pair_sync_us");
+	}
+	fprintf(stdout, "\n");
+}
+
+static void print_pair_header(void) {
+	const char* const statistics[] = {
+	    "min", "max", "avg", "median", "var", "std"};
+	char column[FIELD_WIDTH];
+	int i;
+
+	if (options.format == PLAIN) {
+		fprintf(stdout,
+		        "%-*s%*s%*s%*s",
+		        10,
+		        "pair",
+		        FIELD_WIDTH,
+		        "sender",
+		        FIELD_WIDTH,
+		        "receiver",
+		        FIELD_WIDTH,
+		        "msg_size");
+	}
+	else if (options.format == CSV) {
+		fprintf(stdout, "pair,sender,receiver,msg_size");
+	}
+	else {
+		return;
+	}
+	for (i = 0; i < 6; ++i) {
+		snprintf(column, sizeof(column), "%s_%s", statistics[i], metric_name());
+		print_column_header(column);
+	}
+	if (options.subtype == BW) {
+		print_column_header("msg_rate");
+	}
+	print_percentile_header(metric_name());
+}
+
+void print_percentiles(const struct statistics_t* statistics) {
+	const double percentiles[] = {statistics->p90,
+	                              statistics->p99,
+	                              statistics->p999,
+	                              statistics->p9999};
+	int i;
+
+	for (i = 0; i < 4; ++i) {
+		if (options.format == PLAIN) {
+			fprintf(
+			    stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION, percentiles[i]);
+		}
+		else {
+			fprintf(stdout, ",%.*f", FLOAT_PRECISION, percentiles[i]);
+		}
+	}
+	if (options.adaptive) {
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%*.*f%*.*f%*d",
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics->ci_low,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics->ci_high,
+			        FIELD_WIDTH,
+			        statistics->samples);
+		}
+		else {
+			fprintf(stdout,
+			        ",%.*f,%.*f,%d",
+			        FLOAT_PRECISION,
+			        statistics->ci_low,
+			        FLOAT_PRECISION,
+			        statistics->ci_high,
+			        statistics->samples);
+		}
+	}
+	for (i = 0; i < perf_num_counters(); ++i) {
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%*.*f",
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics->counters[i]);
+		}
+		else {
+			fprintf(stdout, ",%.*f", FLOAT_PRECISION, statistics->counters[i]);
+		}
+	}
+	if (placement_node() != PLACEMENT_ANY) {
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%*d%*d",
+			        FIELD_WIDTH,
+			        placement_node(),
+			        FIELD_WIDTH,
+			        placement_nic_local());
+		}
+		else {
+			fprintf(stdout, ",%d,%d", placement_node(), placement_nic_local());
+		}
+	}
+	if (sweep_windows()) {
+		if (options.format == PLAIN) {
+			fprintf(stdout, "%*d", FIELD_WIDTH, options.window_size);
+		}
+		else {
+			fprintf(stdout, ",%d", options.window_size);
+		}
+	}
+	if (stripe_active()) {
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%*d%*d",
+			        FIELD_WIDTH,
+			        stripe_queues(),
+			        FIELD_WIDTH,
+			        stripe_chunks());
+		}
+		else {
+			fprintf(stdout, ",%d,%d", stripe_queues(), stripe_chunks());
+		}
+	}
+	if (offsets_configs() > 1) {
+		if (options.format == PLAIN) {
+			fprintf(
+			    stdout, "%*s", FIELD_WIDTH, offsets_cold() ? "cold" : "hot");
+		}
+		else {
+			fprintf(stdout, ",%s", offsets_cold() ? "cold" : "hot");
+		}
+	}
+	if (delivery_active()) {
+		if (options.format == PLAIN) {
+			fprintf(stdout, "%*s", FIELD_WIDTH, delivery_name());
+		}
+		else {
+			fprintf(stdout, ",%s", delivery_name());
+		}
+	}
+	if (pair_sync_enabled()) {
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%*.*f",
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        pair_sync_cost() * 1e-3);
+		}
+		else {
+			fprintf(stdout, ",%.*f", FLOAT_PRECISION, pair_sync_cost() * 1e-3);
+		}
+	}
+	fprintf(stdout, "\n");
 }
 
 void print_result(const gaspi_rank_t id,
@@ -444,12 +1490,14 @@ void print_result(const gaspi_rank_t id,
 	struct statistics_t statistics;
 	size_t bytes;
 	int i;
+	raw_sink_flush(size);
 	if (id == 0) {
 		bytes = size * options.window_size;
 		compute_statistics(measurements, &statistics, bytes);
+		sweep_record(statistics.median);
 		if (options.format == PLAIN) {
 			fprintf(stdout,
-			        "%-*s%*d%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f\n",
+			        "%-*s%*d%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
 			        10,
 			        options.memory_mode,
 			        FIELD_WIDTH,
@@ -472,10 +1520,11 @@ void print_result(const gaspi_rank_t id,
 			        FIELD_WIDTH,
 			        FLOAT_PRECISION,
 			        statistics.std);
+			print_percentiles(&statistics);
 		}
 		else if (options.format == CSV) {
 			fprintf(stdout,
-			        "%s,%d,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f\n",
+			        "%s,%d,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
 			        options.memory_mode,
 			        size,
 			        FLOAT_PRECISION,
@@ -487,9 +1536,17 @@ void print_result(const gaspi_rank_t id,
 			        FLOAT_PRECISION,
 			        statistics.median,
 			        FLOAT_PRECISION,
-			        statistics.std,
+			        statistics.var,
 			        FLOAT_PRECISION,
-			        statistics.var);
+			        statistics.std);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_string("memory_mode", options.memory_mode);
+			json_int("msg_size", size);
+			json_statistics(metric_name(), &statistics);
+			json_record_end();
 		}
 		else if (options.format == RAW_CSV) {
 			for (i = 0; i < measurements.n; ++i) {
@@ -498,7 +1555,564 @@ void print_result(const gaspi_rank_t id,
 				        size,
 				        i,
 				        FLOAT_PRECISION,
-				        measurements.time[i]);
+				        convert_time(measurements.time[i],
+				                     metric_scale(bytes)));
+			}
+		}
+		fflush(stdout);
+	}
+}
+
+static void print_pair_row(const char* pair,
+                           const char* sender,
+                           const char* receiver,
+                           const struct statistics_t* statistics,
+                           const size_t size) {
+	const double rate = statistics->median * 1e6 / size;
+
+	if (options.format == PLAIN) {
+		fprintf(stdout,
+		        "%-*s%*s%*s%*zu%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
+		        10,
+		        pair,
+		        FIELD_WIDTH,
+		        sender,
+		        FIELD_WIDTH,
+		        receiver,
+		        FIELD_WIDTH,
+		        size,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->min,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->max,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->avg,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->median,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->var,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->std);
+		if (options.subtype == BW) {
+			fprintf(stdout, "%*.*f", FIELD_WIDTH, FLOAT_PRECISION, rate);
+		}
+		print_percentiles(statistics);
+	}
+	else if (options.format == CSV) {
+		fprintf(stdout,
+		        "%s,%s,%s,%zu,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
+		        pair,
+		        sender,
+		        receiver,
+		        size,
+		        FLOAT_PRECISION,
+		        statistics->min,
+		        FLOAT_PRECISION,
+		        statistics->max,
+		        FLOAT_PRECISION,
+		        statistics->avg,
+		        FLOAT_PRECISION,
+		        statistics->median,
+		        FLOAT_PRECISION,
+		        statistics->var,
+		        FLOAT_PRECISION,
+		        statistics->std);
+		if (options.subtype == BW) {
+			fprintf(stdout, ",%.*f", FLOAT_PRECISION, rate);
+		}
+		print_percentiles(statistics);
+	}
+	else if (options.format == NDJSON) {
+		json_record_begin();
+		json_string("pair", pair);
+		json_string("sender", sender);
+		json_string("receiver", receiver);
+		json_int("msg_size", size);
+		if (options.subtype == BW) {
+			json_double("msg_rate", rate);
+		}
+		json_statistics(metric_name(), statistics);
+		json_record_end();
+	}
+}
+
+/*
+ * Bandwidths and rates of the pairs add up, latencies are averaged. The
+ * counters stay means per iteration and rank.
+ */
+static void aggregate_pairs(const struct statistics_t* pairs,
+                            const int n,
+                            struct statistics_t* total) {
+	const double weight = options.subtype == BW ? 1.0 : 1.0 / n;
+	int i, c;
+
+	memset(total, 0, sizeof(*total));
+	for (i = 0; i < n; ++i) {
+		total->min += weight * pairs[i].min;
+		total->max += weight * pairs[i].max;
+		total->avg += weight * pairs[i].avg;
+		total->median += weight * pairs[i].median;
+		total->var += weight * pairs[i].var;
+		total->p90 += weight * pairs[i].p90;
+		total->p99 += weight * pairs[i].p99;
+		total->p999 += weight * pairs[i].p999;
+		total->p9999 += weight * pairs[i].p9999;
+		total->samples += pairs[i].samples;
+		for (c = 0; c < PERF_MAX_COUNTERS; ++c) {
+			total->counters[c] += pairs[i].counters[c] / n;
+		}
+	}
+	total->std = sqrt(total->var);
+}
+
+/*
+ * One row per pair, measured on its sender, followed by the row "all" of
+ * all pairs running at once. Collective, rank 0 prints.
+ */
+void print_pair_result(const gaspi_rank_t id,
+                       struct measurements_t measurements,
+                       const size_t size) {
+	struct statistics_t statistics, total, *pairs;
+	char pair[16], sender[16], receiver[16];
+	int i;
+	raw_sink_flush(size);
+	if (pairs_sender()) {
+		compute_statistics(
+		    measurements, &statistics, size * options.window_size);
+	}
+	pairs = pairs_gather(&statistics, sizeof(statistics));
+	if (id == 0) {
+		for (i = 0; i < pairs_count(); ++i) {
+			snprintf(pair, sizeof(pair), "%d", i);
+			snprintf(sender, sizeof(sender), "%d", pairs_first(i));
+			snprintf(receiver, sizeof(receiver), "%d", pairs_second(i));
+			print_pair_row(pair, sender, receiver, &pairs[i], size);
+		}
+		aggregate_pairs(pairs, pairs_count(), &total);
+		sweep_record(total.median);
+		print_pair_row("all", "-", "-", &total, size);
+		free(pairs);
+		fflush(stdout);
+	}
+}
+
+static void print_oneway_row(const char* direction,
+                             struct measurements_t measurements,
+                             const struct statistics_t* statistics,
+                             const double asymmetry,
+                             const double clock_error,
+                             const size_t size) {
+	int i;
+
+	if (options.format == PLAIN) {
+		fprintf(stdout,
+		        "%-*s%*zu%*s%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
+		        10,
+		        options.memory_mode,
+		        FIELD_WIDTH,
+		        size,
+		        FIELD_WIDTH,
+		        direction,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->min,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->max,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->avg,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->median,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->var,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        statistics->std,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        asymmetry,
+		        FIELD_WIDTH,
+		        FLOAT_PRECISION,
+		        clock_error);
+		print_percentiles(statistics);
+	}
+	else if (options.format == CSV) {
+		fprintf(stdout,
+		        "%s,%zu,%s,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
+		        options.memory_mode,
+		        size,
+		        direction,
+		        FLOAT_PRECISION,
+		        statistics->min,
+		        FLOAT_PRECISION,
+		        statistics->max,
+		        FLOAT_PRECISION,
+		        statistics->avg,
+		        FLOAT_PRECISION,
+		        statistics->median,
+		        FLOAT_PRECISION,
+		        statistics->var,
+		        FLOAT_PRECISION,
+		        statistics->std,
+		        FLOAT_PRECISION,
+		        asymmetry,
+		        FLOAT_PRECISION,
+		        clock_error);
+		print_percentiles(statistics);
+	}
+	else if (options.format == NDJSON) {
+		json_record_begin();
+		json_string("memory_mode", options.memory_mode);
+		json_int("msg_size", size);
+		json_string("direction", direction);
+		json_double("asym_lat", asymmetry);
+		json_double("clock_err", clock_error);
+		json_statistics("lat", statistics);
+		json_record_end();
+	}
+	else if (options.format == RAW_CSV) {
+		for (i = 0; i < measurements.n; ++i) {
+			fprintf(stdout,
+			        "%zu,%s,%d,%.*f\n",
+			        size,
+			        direction,
+			        i,
+			        FLOAT_PRECISION,
+			        convert_time(measurements.time[i], metric_scale(size)));
+		}
+	}
+}
+
+/*
+ * One row per direction, asym_lat is the median of the direction minus the
+ * median of the opposite direction. clock_err is the residual of the clock
+ * model in ns, the one-way latencies are not more precise than that.
+ */
+void print_oneway_result(const gaspi_rank_t id,
+                         struct measurements_t forward,
+                         struct measurements_t backward,
+                         const size_t size,
+                         const double clock_error) {
+	struct statistics_t there, back;
+	const double error = convert_time(clock_error, metric_scale(size));
+	raw_sink_flush(size);
+	if (id == 0) {
+		compute_statistics(forward, &there, size);
+		compute_statistics(backward, &back, size);
+		sweep_record(there.median + back.median);
+		print_oneway_row("0->1",
+		                 forward,
+		                 &there,
+		                 there.median - back.median,
+		                 error,
+		                 size);
+		print_oneway_row("1->0",
+		                 backward,
+		                 &back,
+		                 back.median - there.median,
+		                 error,
+		                 size);
+		fflush(stdout);
+	}
+}
+
+/*
+ * One row per thread and queue count, the bandwidth is the aggregate of all
+ * threads and msg_rate the messages per second at the median bandwidth.
+ */
+void print_threaded_result(const gaspi_rank_t id,
+                           struct measurements_t measurements,
+                           const size_t size,
+                           const int threads,
+                           const int queues) {
+	struct statistics_t statistics;
+	size_t bytes;
+	double rate;
+	int i;
+	raw_sink_flush(size);
+	if (id == 0) {
+		bytes = size * options.window_size * threads;
+		compute_statistics(measurements, &statistics, bytes);
+		sweep_record(statistics.median);
+		rate = statistics.median * 1e6 / size;
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%-*d%*d%*zu%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
+			        10,
+			        threads,
+			        FIELD_WIDTH,
+			        queues,
+			        FIELD_WIDTH,
+			        size,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.min,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.max,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.avg,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.median,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.var,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.std,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        rate);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == CSV) {
+			fprintf(stdout,
+			        "%d,%d,%zu,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
+			        threads,
+			        queues,
+			        size,
+			        FLOAT_PRECISION,
+			        statistics.min,
+			        FLOAT_PRECISION,
+			        statistics.max,
+			        FLOAT_PRECISION,
+			        statistics.avg,
+			        FLOAT_PRECISION,
+			        statistics.median,
+			        FLOAT_PRECISION,
+			        statistics.var,
+			        FLOAT_PRECISION,
+			        statistics.std,
+			        FLOAT_PRECISION,
+			        rate);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_int("threads", threads);
+			json_int("queues", queues);
+			json_int("msg_size", size);
+			json_double("msg_rate", rate);
+			json_statistics("bw", &statistics);
+			json_record_end();
+		}
+		else if (options.format == RAW_CSV) {
+			for (i = 0; i < measurements.n; ++i) {
+				fprintf(stdout,
+				        "%d,%d,%zu,%d,%.*f\n",
+				        threads,
+				        queues,
+				        size,
+				        i,
+				        FLOAT_PRECISION,
+				        convert_time(measurements.time[i],
+				                     metric_scale(bytes)));
+			}
+		}
+		fflush(stdout);
+	}
+}
+
+/*
+ * The latency columns are the times of post, compute and completion together.
+ * communication and compute are the times of the operation and of the kernel
+ * alone in ns, overlap the percentage of the communication hidden behind the
+ * kernel and progress the percentage of iterations that completed during the
+ * kernel without a call into the library.
+ */
+void print_overlap_result(const gaspi_rank_t id,
+                          struct measurements_t measurements,
+                          const size_t size,
+                          const double communication,
+                          const double compute,
+                          const double progress) {
+	struct statistics_t statistics;
+	const double comm_lat = communication * 1e-3;
+	const double compute_lat = compute * 1e-3;
+	double overlap;
+	int i;
+	raw_sink_flush(size);
+	if (id == 0) {
+		compute_statistics(measurements, &statistics, size);
+		sweep_record(statistics.median);
+		overlap = 100.0 * (1.0 - (statistics.median - compute_lat) / comm_lat);
+		overlap = fmax(0.0, fmin(100.0, overlap));
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%-*zu%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
+			        10,
+			        size,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        comm_lat,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        compute_lat,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.min,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.max,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.avg,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.median,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.var,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.std,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        overlap,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        100.0 * progress);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == CSV) {
+			fprintf(stdout,
+			        "%zu,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
+			        size,
+			        FLOAT_PRECISION,
+			        comm_lat,
+			        FLOAT_PRECISION,
+			        compute_lat,
+			        FLOAT_PRECISION,
+			        statistics.min,
+			        FLOAT_PRECISION,
+			        statistics.max,
+			        FLOAT_PRECISION,
+			        statistics.avg,
+			        FLOAT_PRECISION,
+			        statistics.median,
+			        FLOAT_PRECISION,
+			        statistics.var,
+			        FLOAT_PRECISION,
+			        statistics.std,
+			        FLOAT_PRECISION,
+			        overlap,
+			        FLOAT_PRECISION,
+			        100.0 * progress);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_int("msg_size", size);
+			json_double("comm_lat", comm_lat);
+			json_double("compute_lat", compute_lat);
+			json_double("overlap", overlap);
+			json_double("progress", 100.0 * progress);
+			json_statistics("lat", &statistics);
+			json_record_end();
+		}
+		else if (options.format == RAW_CSV) {
+			for (i = 0; i < measurements.n; ++i) {
+				fprintf(stdout,
+				        "%zu,%d,%.*f\n",
+				        size,
+				        i,
+				        FLOAT_PRECISION,
+				        convert_time(measurements.time[i],
+				                     metric_scale(size)));
+			}
+		}
+		fflush(stdout);
+	}
+}
+
+void print_segment_result(const gaspi_rank_t id,
+                          struct measurements_t measurements,
+                          const size_t size,
+                          const int ranks,
+                          const char* operation) {
+	struct statistics_t statistics;
+	int i;
+	raw_sink_flush(size);
+	if (id == 0) {
+		compute_statistics(measurements, &statistics, size);
+		if (options.format == PLAIN) {
+			fprintf(stdout,
+			        "%-*zu%*d%*s%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
+			        10,
+			        size,
+			        FIELD_WIDTH,
+			        ranks,
+			        FIELD_WIDTH,
+			        operation,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.min,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.max,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.avg,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.median,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.var,
+			        FIELD_WIDTH,
+			        FLOAT_PRECISION,
+			        statistics.std);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == CSV) {
+			fprintf(stdout,
+			        "%zu,%d,%s,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
+			        size,
+			        ranks,
+			        operation,
+			        FLOAT_PRECISION,
+			        statistics.min,
+			        FLOAT_PRECISION,
+			        statistics.max,
+			        FLOAT_PRECISION,
+			        statistics.avg,
+			        FLOAT_PRECISION,
+			        statistics.median,
+			        FLOAT_PRECISION,
+			        statistics.var,
+			        FLOAT_PRECISION,
+			        statistics.std);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_int("size", size);
+			json_int("ranks", ranks);
+			json_string("operation", operation);
+			json_statistics("lat", &statistics);
+			json_record_end();
+		}
+		else if (options.format == RAW_CSV) {
+			for (i = 0; i < measurements.n; ++i) {
+				fprintf(stdout,
+				        "%zu,%d,%s,%d,%.*f\n",
+				        size,
+				        ranks,
+				        operation,
+				        i,
+				        FLOAT_PRECISION,
+				        convert_time(measurements.time[i], metric_scale(size)));
 			}
 		}
 		fflush(stdout);
@@ -540,6 +2154,15 @@ void print_barrier_result(const gaspi_rank_t id,
 			        FLOAT_PRECISION,
 			        avg_time);
 		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_int("ranks", num_pes);
+			json_int("iterations", options.iterations);
+			json_double("min_lat", min_time);
+			json_double("max_lat", max_time);
+			json_double("avg_lat", avg_time);
+			json_record_end();
+		}
 	}
 	fflush(stdout);
 }
@@ -586,6 +2209,17 @@ void print_allreduce_result(const gaspi_rank_t id,
 			        FLOAT_PRECISION,
 			        avg_time);
 		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_string("memory_mode", options.memory_mode);
+			json_int("msg_size", size);
+			json_int("ranks", num_pes);
+			json_int("iterations", options.iterations);
+			json_double("min_lat", min_time);
+			json_double("max_lat", max_time);
+			json_double("avg_lat", avg_time);
+			json_record_end();
+		}
 	}
 	fflush(stdout);
 }
@@ -594,15 +2228,16 @@ void print_list_lat(const gaspi_rank_t id,
                     const size_t stride_count,
                     struct measurements_t measurements) {
 	struct statistics_t statistics;
+	raw_sink_flush(stride_count);
 	if (id == 0) {
 		compute_statistics(measurements, &statistics, 0);
 		if (options.format == PLAIN) {
 			fprintf(stdout,
-			        "%-*d%*d%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f\n",
+			        "%-*d%*d%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
 			        10,
 			        stride_count,
 			        FIELD_WIDTH,
-			        options.iterations,
+			        statistics.samples,
 			        FIELD_WIDTH,
 			        FLOAT_PRECISION,
 			        statistics.min,
@@ -621,12 +2256,13 @@ void print_list_lat(const gaspi_rank_t id,
 			        FIELD_WIDTH,
 			        FLOAT_PRECISION,
 			        statistics.std);
+			print_percentiles(&statistics);
 		}
 		else if (options.format == CSV) {
 			fprintf(stdout,
-			        "%d,%d,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f\n",
+			        "%d,%d,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
 			        stride_count,
-			        options.iterations,
+			        statistics.samples,
 			        FLOAT_PRECISION,
 			        statistics.min,
 			        FLOAT_PRECISION,
@@ -639,6 +2275,13 @@ void print_list_lat(const gaspi_rank_t id,
 			        statistics.var,
 			        FLOAT_PRECISION,
 			        statistics.std);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_int("segments", stride_count);
+			json_statistics("lat", &statistics);
+			json_record_end();
 		}
 		fflush(stdout);
 	}
@@ -648,11 +2291,12 @@ void print_notify_lat(const gaspi_rank_t id,
                       struct measurements_t measurements) {
 	struct statistics_t statistics;
 	int i;
+	raw_sink_flush(0);
 	if (id == 0) {
 		compute_statistics(measurements, &statistics, 0);
 		if (options.format == PLAIN) {
 			fprintf(stdout,
-			        "%-*.*f%*.*f%*.*f%*.*f%*.*f%*.*f\n",
+			        "%-*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
 			        10,
 			        FLOAT_PRECISION,
 			        statistics.min,
@@ -671,10 +2315,11 @@ void print_notify_lat(const gaspi_rank_t id,
 			        FIELD_WIDTH,
 			        FLOAT_PRECISION,
 			        statistics.std);
+			print_percentiles(&statistics);
 		}
 		else if (options.format == CSV) {
 			fprintf(stdout,
-			        "%.*f,%.*f,%.*f,%.*f,%.*f,%.*f\n",
+			        "%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
 			        FLOAT_PRECISION,
 			        statistics.min,
 			        FLOAT_PRECISION,
@@ -687,6 +2332,12 @@ void print_notify_lat(const gaspi_rank_t id,
 			        statistics.var,
 			        FLOAT_PRECISION,
 			        statistics.std);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_statistics(metric_name(), &statistics);
+			json_record_end();
 		}
 		else if (options.format == RAW_CSV) {
 			for (i = 0; i < measurements.n; ++i) {
@@ -694,7 +2345,7 @@ void print_notify_lat(const gaspi_rank_t id,
 				        "%d,%.*f\n",
 				        i,
 				        FLOAT_PRECISION,
-				        measurements.time[i]);
+				        convert_time(measurements.time[i], metric_scale(0)));
 			}
 		}
 		fflush(stdout);
@@ -705,13 +2356,14 @@ void print_atomic_lat(const gaspi_rank_t id,
                       struct measurements_t measurements) {
 	struct statistics_t statistics;
 	int i, n;
+	raw_sink_flush(0);
 	if (id == 0) {
 		compute_statistics(measurements, &statistics, 0);
 		if (options.format == PLAIN) {
 			fprintf(stdout,
-			        "%-*d%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f\n",
+			        "%-*d%*.*f%*.*f%*.*f%*.*f%*.*f%*.*f",
 			        10,
-			        options.iterations,
+			        statistics.samples,
 			        FIELD_WIDTH,
 			        FLOAT_PRECISION,
 			        statistics.min,
@@ -730,11 +2382,12 @@ void print_atomic_lat(const gaspi_rank_t id,
 			        FIELD_WIDTH,
 			        FLOAT_PRECISION,
 			        statistics.std);
+			print_percentiles(&statistics);
 		}
 		else if (options.format == CSV) {
 			fprintf(stdout,
-			        "%d,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f\n",
-			        options.iterations,
+			        "%d,%.*f,%.*f,%.*f,%.*f,%.*f,%.*f",
+			        statistics.samples,
 			        FLOAT_PRECISION,
 			        statistics.min,
 			        FLOAT_PRECISION,
@@ -747,6 +2400,12 @@ void print_atomic_lat(const gaspi_rank_t id,
 			        statistics.var,
 			        FLOAT_PRECISION,
 			        statistics.std);
+			print_percentiles(&statistics);
+		}
+		else if (options.format == NDJSON) {
+			json_record_begin();
+			json_statistics("lat", &statistics);
+			json_record_end();
 		}
 		else if (options.format == RAW_CSV) {
 			for (i = 0; i < measurements.n; ++i) {
@@ -754,9 +2413,37 @@ void print_atomic_lat(const gaspi_rank_t id,
 				        "%d,%.*f\n",
 				        i,
 				        FLOAT_PRECISION,
-				        measurements.time[i]);
+				        convert_time(measurements.time[i], metric_scale(0)));
 			}
 		}
 		fflush(stdout);
 	}
 }
+
+/*
+ * Time spent registering segments, kept out of the results. Comment lines
+ * would break the CSV formats, there it goes to stderr.
+ */
+void print_registration(const gaspi_rank_t id) {
+	FILE* f = options.format == PLAIN ? stdout : stderr;
+
+	if (id != 0) {
+		return;
+	}
+	if (options.format == NDJSON) {
+		json_record_begin();
+		json_int("registrations", registration.segments);
+		json_int("registered_bytes", registration.bytes);
+		json_double("registration_ms", registration.time / 1e6);
+		json_record_end();
+	}
+	else {
+		fprintf(f,
+		        "# %d segment registrations, %zu bytes, %.*f ms\n",
+		        registration.segments,
+		        registration.bytes,
+		        FLOAT_PRECISION,
+		        registration.time / 1e6);
+	}
+	fflush(f);
+}
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "util_perf.h"
 
 #ifndef FIELD_WIDTH
 #define FIELD_WIDTH 20
@@ -18,7 +19,16 @@
 
 enum options_ret_type { OPTIONS_OKAY = 0, OPTIONS_HELP, OPTIONS_BAD_USAGE };
 
-enum benchmark_type { COLLECTIVE = 0, PASSIVE, ONESIDED, ATOMIC, NOTIFY };
+enum benchmark_type {
+	COLLECTIVE = 0,
+	PASSIVE,
+	ONESIDED,
+	ATOMIC,
+	NOTIFY,
+	DRIVER,
+	THREADED,
+	MULTIPAIR
+};
 
 enum benchmark_subtype {
 	BW = 0,
@@ -27,14 +37,25 @@ enum benchmark_subtype {
 	BARRIER,
 	RATE,
 	PINGPONG,
-	STRIDED
+	STRIDED,
+	ONEWAY,
+	SEGMENT,
+	OVERLAP
 };
 
-enum output_format { PLAIN = 0, CSV, RAW_CSV };
+enum output_format { PLAIN = 0, CSV, RAW_CSV, NDJSON };
+
+struct stream_statistics_t;
 
+/*
+ * Iteration times in ns. In streaming mode time is NULL and the samples are
+ * folded into stream instead of being stored. In adaptive mode n counts the
+ * samples recorded so far.
+ */
 struct measurements_t {
 	double* time;
 	int n;
+	struct stream_statistics_t* stream;
 };
 
 struct statistics_t {
@@ -44,6 +65,14 @@ struct statistics_t {
 	double median;
 	double std;
 	double var;
+	double p90;
+	double p99;
+	double p999;
+	double p9999;
+	double ci_low;
+	double ci_high;
+	int samples;
+	double counters[PERF_MAX_COUNTERS]; // mean per timed iteration
 };
 
 struct bad_usage_t {
@@ -63,22 +92,83 @@ struct benchmark_options_t {
 	int skip;
 	int single_buffer;
 	int verify;
+	int verify_every; // 0 to verify the first iteration only
 	int gaspi_timer;
+	int streaming;
+	int adaptive;
+	int max_iterations;
+	double ci_width;
+	double time_budget;
 
 	size_t min_message_size;
 	size_t max_message_size;
 
 	char* name;
 	char* memory_mode;
+	char* kernels;
+	int list_kernels;
+	char* raw_file;
+	char* cpu_list;
+	char* numa_node;
+	int numa_sweep;
+	int arena;
+	char* hugepages;
+	size_t offset_span; // 0 unless --random-offsets is given
+	size_t cold_footprint; // 0 unless --cold-cache is given
+	size_t cold_stride;
+	int threads;
+	int queues; // 0 for a queue per thread
+	char* pairing;
+	int queue_depth; // 0 without flow control
+	double compute_time; // us, 0 for the communication time
+	int polling;
+	char* delivery;
 };
 
 int benchmark_options(int argc, char* argv[]);
 void print_header(const gaspi_rank_t id);
+void init_measurements(struct measurements_t* measurements);
+void record_measurement(struct measurements_t* measurements,
+                        const int i,
+                        const double start,
+                        const double time);
+void record_round_trip(struct measurements_t* measurements,
+                       const int i,
+                       const double start,
+                       const double time);
+void free_measurements(struct measurements_t* measurements);
+void print_percentile_header(const char* metric);
+void print_percentiles(const struct statistics_t* statistics);
+void print_registration(const gaspi_rank_t id);
 void print_bad_usage(void);
 void print_help_message(void);
 void print_result(const gaspi_rank_t id,
                   struct measurements_t timings,
                   const size_t size);
+void print_segment_result(const gaspi_rank_t id,
+                          struct measurements_t measurements,
+                          const size_t size,
+                          const int ranks,
+                          const char* operation);
+void print_threaded_result(const gaspi_rank_t id,
+                           struct measurements_t measurements,
+                           const size_t size,
+                           const int threads,
+                           const int queues);
+void print_pair_result(const gaspi_rank_t id,
+                       struct measurements_t measurements,
+                       const size_t size);
+void print_overlap_result(const gaspi_rank_t id,
+                          struct measurements_t measurements,
+                          const size_t size,
+                          const double communication,
+                          const double compute,
+                          const double progress);
+void print_oneway_result(const gaspi_rank_t id,
+                         struct measurements_t forward,
+                         struct measurements_t backward,
+                         const size_t size,
+                         const double clock_error);
 void print_allreduce_result(const gaspi_rank_t i,
                             const int num_pes,
                             const size_t size,
@@ -0,0 +1,240 @@
+#include "util_adaptive.h"
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+#include "check.h"
+#include "util_perf.h"
+#include "util_raw.h"
+
+struct adaptive_t {
+	struct timespec start;
+	int next_check;
+	int stable;
+	gaspi_rank_t rank;
+};
+
+static struct adaptive_t adaptive;
+static uint64_t rng_state;
+
+static double elapsed(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - adaptive.start.tv_sec) +
+	       (now.tv_nsec - adaptive.start.tv_nsec) * 1e-9;
+}
+
+// xorshift64*, seeded per bootstrap so that results are reproducible
+static uint64_t next_random(void) {
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static int double_cmp(const void* a, const void* b) {
+	const double x = *((const double*) (a));
+	const double y = *((const double*) (b));
+	return (x > y) - (x < y);
+}
+
+// k-th smallest value, reorders t
+static double select_kth(double* t, const int n, const int k) {
+	int left = 0, right = n - 1, i, j;
+	double pivot, swap;
+
+	while (left < right) {
+		pivot = t[left + (right - left) / 2];
+		i = left;
+		j = right;
+		while (i <= j) {
+			while (t[i] < pivot) {
+				++i;
+			}
+			while (t[j] > pivot) {
+				--j;
+			}
+			if (i <= j) {
+				swap = t[i];
+				t[i++] = t[j];
+				t[j--] = swap;
+			}
+		}
+		if (k <= j) {
+			right = j;
+		}
+		else if (k >= i) {
+			left = i;
+		}
+		else {
+			break;
+		}
+	}
+	return t[k];
+}
+
+static double median(const double* t, const int n) {
+	double* copy = malloc(n * sizeof(*copy));
+	double m;
+
+	memcpy(copy, t, n * sizeof(*copy));
+	m = select_kth(copy, n, n / 2);
+	free(copy);
+	return m;
+}
+
+// percentile bootstrap of the median
+void bootstrap_median_ci(const double* t,
+                         const int n,
+                         double* low,
+                         double* high) {
+	const double alpha = (1.0 - ADAPTIVE_CONFIDENCE) / 2.0;
+	double *resample, *medians;
+	int b, j;
+
+	resample = malloc(n * sizeof(*resample));
+	medians = malloc(ADAPTIVE_BOOTSTRAP_RESAMPLES * sizeof(*medians));
+	rng_state = 0x9E3779B97F4A7C15ULL;
+	for (b = 0; b < ADAPTIVE_BOOTSTRAP_RESAMPLES; ++b) {
+		for (j = 0; j < n; ++j) {
+			resample[j] = t[next_random() % n];
+		}
+		medians[b] = select_kth(resample, n, n / 2);
+	}
+	qsort(medians, ADAPTIVE_BOOTSTRAP_RESAMPLES, sizeof(*medians), double_cmp);
+	*low = medians[(int) (alpha * ADAPTIVE_BOOTSTRAP_RESAMPLES)];
+	*high = medians[(int) ceil((1.0 - alpha) * ADAPTIVE_BOOTSTRAP_RESAMPLES) -
+	                1];
+	free(resample);
+	free(medians);
+}
+
+static void mean_var(const double* t, const int n, double* mean, double* var) {
+	double sum = 0;
+	int i;
+
+	for (i = 0; i < n; ++i) {
+		sum += t[i];
+	}
+	*mean = sum / n;
+	sum = 0;
+	for (i = 0; i < n; ++i) {
+		sum += (t[i] - *mean) * (t[i] - *mean);
+	}
+	*var = n > 1 ? sum / (n - 1) : 0;
+}
+
+// Welch t statistic of the first against the second half of the samples
+static double warmup_t(const double* t, const int n) {
+	const int half = n / 2;
+	double mean_a, var_a, mean_b, var_b, se;
+
+	mean_var(t, half, &mean_a, &var_a);
+	mean_var(t + half, n - half, &mean_b, &var_b);
+	se = sqrt(var_a / half + var_b / (n - half));
+	if (se == 0) {
+		return mean_a == mean_b ? 0 : INFINITY;
+	}
+	return (mean_a - mean_b) / se;
+}
+
+/*
+ * While the first half of the samples differs significantly from the second
+ * half it is treated as warm-up and dropped. Afterwards the loop stops once
+ * the confidence interval of the median is narrow enough.
+ */
+static int checkpoint(struct measurements_t* measurements) {
+	const int n = measurements->n;
+	double low, high;
+
+	if (elapsed() > options.time_budget) {
+		return 1;
+	}
+	if (n < ADAPTIVE_MIN_SAMPLES) {
+		return 0;
+	}
+	if (!adaptive.stable) {
+		if (fabs(warmup_t(measurements->time, n)) > ADAPTIVE_WARMUP_T) {
+			memmove(measurements->time,
+			        measurements->time + n / 2,
+			        (n - n / 2) * sizeof(*measurements->time));
+			measurements->n = n - n / 2;
+			raw_sink_discard(n / 2);
+			return 0;
+		}
+		adaptive.stable = 1;
+	}
+	bootstrap_median_ci(measurements->time, n, &low, &high);
+	return high - low <= options.ci_width * median(measurements->time, n);
+}
+
+/*
+ * Checkpoints double their spacing, but never plan beyond the time budget as
+ * estimated from the mean iteration time so far. Collective loops only test
+ * the budget at checkpoints and would overshoot it by up to a factor of two.
+ */
+static int next_checkpoint(const int i) {
+	const double spent = elapsed();
+	double remaining;
+
+	if (spent <= 0) {
+		return 2 * i;
+	}
+	// iterations that still fit into the budget
+	remaining = (options.time_budget - spent) * i / spent;
+	if (remaining >= i) {
+		return 2 * i;
+	}
+	return remaining < 1 ? i + 1 : i + (int) remaining;
+}
+
+int measure_continue(struct measurements_t* measurements,
+                     const int i,
+                     const int collective) {
+	int decision[2], local[2] = {0, 0};
+
+	if (i == 0) {
+		perf_reset();
+	}
+	if (!options.adaptive) {
+		return i < options.iterations + options.skip;
+	}
+	if (i == 0) {
+		clock_gettime(CLOCK_MONOTONIC, &adaptive.start);
+		adaptive.next_check = options.iterations > ADAPTIVE_MIN_SAMPLES
+		                          ? options.iterations
+		                          : ADAPTIVE_MIN_SAMPLES;
+		adaptive.stable = 0;
+		measurements->n = 0;
+		GASPI_CHECK(gaspi_proc_rank(&adaptive.rank));
+		return 1;
+	}
+	if (i >= options.max_iterations) {
+		return 0;
+	}
+	// ranks must only leave a common loop together, i.e. at a checkpoint
+	if (!collective && elapsed() > options.time_budget) {
+		return 0;
+	}
+	if (i < adaptive.next_check) {
+		return 1;
+	}
+	// rank 0 decides and plans the next checkpoint, the others contribute 0
+	if (!collective || adaptive.rank == 0) {
+		local[0] = checkpoint(measurements);
+		local[1] = next_checkpoint(i);
+	}
+	if (!collective) {
+		adaptive.next_check = local[1];
+		return !local[0];
+	}
+	GASPI_CHECK(gaspi_allreduce(local,
+	                            decision,
+	                            2,
+	                            GASPI_OP_MAX,
+	                            GASPI_TYPE_INT,
+	                            GASPI_GROUP_ALL,
+	                            GASPI_BLOCK));
+	adaptive.next_check = decision[1];
+	return !decision[0];
+}
@@ -0,0 +1,32 @@
+#ifndef __UTIL_ADAPTIVE_H__
+#define __UTIL_ADAPTIVE_H__
+#include "util.h"
+
+/*
+ * Iteration control of the measurement loops:
+ *   for (i = 0; measure_continue(&measurements, i, MEASURE_LOCAL); ++i)
+ * Without --adaptive the loop runs options.skip + options.iterations times.
+ * With --adaptive the warm-up ends once a change-point test finds the samples
+ * stable and the loop stops when the bootstrap confidence interval of the
+ * median is narrow enough, the time budget is spent or the maximum number of
+ * iterations is reached.
+ *
+ * Loops that are executed by all ranks in lockstep pass MEASURE_COLLECTIVE,
+ * rank 0 then decides for everybody at the checkpoints.
+ */
+#define MEASURE_LOCAL 0
+#define MEASURE_COLLECTIVE 1
+
+#define ADAPTIVE_MIN_SAMPLES 32
+#define ADAPTIVE_BOOTSTRAP_RESAMPLES 200
+#define ADAPTIVE_CONFIDENCE 0.95
+#define ADAPTIVE_WARMUP_T 3.0
+
+int measure_continue(struct measurements_t* measurements,
+                     const int i,
+                     const int collective);
+void bootstrap_median_ci(const double* t,
+                         const int n,
+                         double* low,
+                         double* high);
+#endif
@@ -0,0 +1,213 @@
+#include "util_clocksync.h"
+#include <math.h>
+#include <string.h>
+#include "benchdefs.h"
+#include "check.h"
+#include "stopwatch.h"
+#include "util_memory.h"
+
+#define PING_ID 0
+#define PONG_ID 1
+
+// global = local + offset + drift * (local - reference)
+struct clock_model_t {
+	double offset;
+	double drift;
+	double reference;
+	double rtt;
+	double error;
+};
+
+static struct clock_model_t model;
+
+// one offset sample per window, from the startup until now
+static double history_local[CLOCKSYNC_HISTORY];
+static double history_offset[CLOCKSYNC_HISTORY];
+static int samples;
+
+static void wait_notification(const gaspi_notification_id_t id) {
+	gaspi_notification_id_t first;
+	gaspi_notification_t value;
+
+	GASPI_CHECK(gaspi_notify_waitsome(
+	    TEMPORARY_SEGMENT_ID, id, 1, &first, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_notify_reset(TEMPORARY_SEGMENT_ID, first, &value));
+}
+
+// rank 0 answers every ping with its current time
+static void serve(const gaspi_rank_t client,
+                  const int windows,
+                  double* buffer) {
+	const gaspi_queue_id_t q_id = 0;
+	int i;
+
+	for (i = 0; i < windows * CLOCKSYNC_ROUNDS; ++i) {
+		wait_notification(PING_ID);
+		buffer[1] = benchmark_timer();
+		GASPI_CHECK(gaspi_write_notify(TEMPORARY_SEGMENT_ID,
+		                               sizeof(double),
+		                               client,
+		                               TEMPORARY_SEGMENT_ID,
+		                               0,
+		                               sizeof(double),
+		                               PONG_ID,
+		                               1,
+		                               q_id,
+		                               GASPI_BLOCK));
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	}
+}
+
+/*
+ * Least-squares line through the offset samples of all windows, the error
+ * is the largest distance of a sample to the line.
+ */
+static void fit(const double* local, const double* offset, const int n) {
+	double mean_x = 0, mean_y = 0, sxx = 0, sxy = 0;
+	int i;
+
+	model.reference = local[0];
+	for (i = 0; i < n; ++i) {
+		mean_x += (local[i] - model.reference) / n;
+		mean_y += offset[i] / n;
+	}
+	for (i = 0; i < n; ++i) {
+		sxx += (local[i] - model.reference - mean_x) *
+		       (local[i] - model.reference - mean_x);
+		sxy += (local[i] - model.reference - mean_x) * (offset[i] - mean_y);
+	}
+	model.drift = sxx > 0 ? sxy / sxx : 0;
+	model.offset = mean_y - model.drift * mean_x;
+	model.error = 0;
+	for (i = 0; i < n; ++i) {
+		model.error = fmax(
+		    model.error,
+		    fabs(offset[i] - model.offset -
+		         model.drift * (local[i] - model.reference)));
+	}
+}
+
+// keeps the sample of the fastest round trip of one window
+static void sample(double* buffer) {
+	const gaspi_queue_id_t q_id = 0;
+	double send, arrival, rtt, best = INFINITY;
+	int r;
+
+	if (samples == CLOCKSYNC_HISTORY) {
+		// forget the oldest window
+		memmove(history_local,
+		        history_local + 1,
+		        (samples - 1) * sizeof(double));
+		memmove(history_offset,
+		        history_offset + 1,
+		        (samples - 1) * sizeof(double));
+		--samples;
+	}
+	for (r = 0; r < CLOCKSYNC_ROUNDS; ++r) {
+		send = benchmark_timer();
+		GASPI_CHECK(gaspi_notify(
+		    TEMPORARY_SEGMENT_ID, 0, PING_ID, 1, q_id, GASPI_BLOCK));
+		wait_notification(PONG_ID);
+		arrival = benchmark_timer();
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+		rtt = arrival - send;
+		if (rtt < best) {
+			best = rtt;
+			history_local[samples] = (send + arrival) / 2;
+			history_offset[samples] = buffer[0] - history_local[samples];
+		}
+	}
+	if (samples == 0 || best < model.rtt) {
+		model.rtt = best;
+	}
+	++samples;
+}
+
+static void synchronize(const int windows, double* buffer) {
+	double next;
+	int w;
+
+	for (w = 0; w < windows; ++w) {
+		sample(buffer);
+		if (w + 1 < windows) {
+			// spread the windows so that the drift becomes visible
+			next = benchmark_timer() + CLOCKSYNC_WINDOW_INTERVAL;
+			while (benchmark_timer() < next) {
+			}
+		}
+	}
+	fit(history_local, history_offset, samples);
+}
+
+/*
+ * Collective, takes windows samples of every rank against rank 0 one rank
+ * after another on a temporary segment and agrees on the largest error.
+ */
+static void exchange(const int windows) {
+	gaspi_rank_t my_id, num_pes, client;
+	gaspi_pointer_t ptr;
+	double error;
+
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+	allocate_gaspi_memory_initialized(TEMPORARY_SEGMENT_ID,
+	                                  2 * sizeof(double));
+	GASPI_CHECK(gaspi_segment_ptr(TEMPORARY_SEGMENT_ID, &ptr));
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+	for (client = 1; client < num_pes; ++client) {
+		if (my_id == 0) {
+			serve(client, windows, ptr);
+		}
+		else if (my_id == client) {
+			synchronize(windows, ptr);
+		}
+		GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+	}
+	free_gaspi_memory(TEMPORARY_SEGMENT_ID);
+	error = model.error;
+	GASPI_CHECK(gaspi_allreduce(&error,
+	                            &model.error,
+	                            1,
+	                            GASPI_OP_MAX,
+	                            GASPI_TYPE_DOUBLE,
+	                            GASPI_GROUP_ALL,
+	                            GASPI_BLOCK));
+}
+
+void clocksync_init(void) {
+	model.offset = 0;
+	model.drift = 0;
+	model.reference = 0;
+	model.rtt = 0;
+	model.error = 0;
+	samples = 0;
+	exchange(CLOCKSYNC_WINDOWS);
+}
+
+void clocksync_update(void) {
+	exchange(1);
+}
+
+double clocksync_global(const double local) {
+	return local + model.offset + model.drift * (local - model.reference);
+}
+
+// offset to rank 0 in ns at the reference time
+double clocksync_offset(void) {
+	return model.offset;
+}
+
+// relative frequency error against rank 0
+double clocksync_drift(void) {
+	return model.drift;
+}
+
+// smallest round trip time to rank 0 in ns, bounds the offset error
+double clocksync_rtt(void) {
+	return model.rtt;
+}
+
+// largest distance in ns of an offset sample of any rank to its fitted line
+double clocksync_error(void) {
+	return model.error;
+}
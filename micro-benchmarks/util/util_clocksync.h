@@ -0,0 +1,39 @@
+#ifndef __UTIL_CLOCKSYNC_H__
+#define __UTIL_CLOCKSYNC_H__
+#include <GASPI.h>
+
+/*
+ * Maps timestamps of the benchmark timer onto the clock of rank 0, so that a
+ * send timestamp taken on one rank and an arrival timestamp taken on another
+ * rank can be subtracted:
+ *   clocksync_init();                       // collective, once at startup
+ *   ...                                     // timestamps of one message size
+ *   clocksync_update();                     // collective, after each size
+ *   latency = clocksync_global(arrival) - clocksync_global(send);
+ *
+ * Every rank exchanges notification ping-pongs with rank 0. Per window of
+ * rounds the round with the smallest round trip time gives an offset sample,
+ * a least-squares line through these samples models offset and drift.
+ * clocksync_update adds one window and fits the line again, so the samples
+ * span the run up to the timestamps being converted instead of extrapolating
+ * the first 80 ms over the whole sweep. clocksync_error is the largest
+ * distance of a sample of any rank to its line.
+ *
+ * A two-way exchange cannot tell a constant difference between the two
+ * directions from a clock offset, the model assumes that the fastest round
+ * trips are symmetric. Asymmetries beyond that, e.g. queueing in only one
+ * direction, show up in the one-way latencies.
+ */
+#define CLOCKSYNC_WINDOWS 16
+#define CLOCKSYNC_ROUNDS 32
+#define CLOCKSYNC_WINDOW_INTERVAL 5e6 // ns between two windows
+#define CLOCKSYNC_HISTORY 256 // windows kept for the fit
+
+void clocksync_init(void);
+void clocksync_update(void);
+double clocksync_global(const double local);
+double clocksync_offset(void);
+double clocksync_drift(void);
+double clocksync_rtt(void);
+double clocksync_error(void);
+#endif
@@ -0,0 +1,131 @@
+#include "util_delivery.h"
+#include <string.h>
+#include "check.h"
+#include "util.h"
+
+#define DELIVERY_MAX_MODES 2
+
+struct delivery_t {
+	int enabled;
+	enum delivery_mode modes[DELIVERY_MAX_MODES]; // given with --delivery
+	int num_modes;
+	enum delivery_mode mode; // of the current pass
+};
+
+static struct delivery_t delivery = {0, {DELIVERY_NOTIFY}, 0, DELIVERY_NOTIFY};
+
+static const char* const mode_names[] = {"notify", "poll"};
+
+void delivery_enable(void) {
+	delivery.enabled = 1;
+}
+
+int delivery_enabled(void) {
+	return delivery.enabled;
+}
+
+// parse a comma separated list of distinct modes
+int delivery_parse(const char* list) {
+	const char* c = list;
+	size_t length;
+	int mode, i;
+
+	if (!delivery.enabled) {
+		return OPTIONS_BAD_USAGE;
+	}
+	delivery.num_modes = 0;
+	do {
+		length = strcspn(c, ",");
+		for (mode = 0; mode < DELIVERY_MAX_MODES; ++mode) {
+			if (strlen(mode_names[mode]) == length &&
+			    strncmp(c, mode_names[mode], length) == 0) {
+				break;
+			}
+		}
+		if (mode == DELIVERY_MAX_MODES) {
+			return OPTIONS_BAD_USAGE;
+		}
+		for (i = 0; i < delivery.num_modes; ++i) {
+			if (delivery.modes[i] == (enum delivery_mode) mode) {
+				return OPTIONS_BAD_USAGE;
+			}
+		}
+		delivery.modes[delivery.num_modes++] = mode;
+		c += length;
+	} while (*c++ == ',');
+	return OPTIONS_OKAY;
+}
+
+// the mode is part of the result once --delivery is given
+int delivery_active(void) {
+	return delivery.num_modes > 0;
+}
+
+int delivery_polls(void) {
+	int i;
+
+	for (i = 0; i < delivery.num_modes; ++i) {
+		if (delivery.modes[i] == DELIVERY_POLL) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int delivery_configs(void) {
+	return delivery.num_modes > 0 ? delivery.num_modes : 1;
+}
+
+void delivery_select(const int config) {
+	delivery.mode =
+	    delivery.num_modes > 0 ? delivery.modes[config] : DELIVERY_NOTIFY;
+}
+
+enum delivery_mode delivery_mode(void) {
+	return delivery.mode;
+}
+
+const char* delivery_name(void) {
+	return mode_names[delivery.mode];
+}
+
+// collective, reports the payloads incomplete at the arrival of their token
+int delivery_ordered(const int unordered) {
+	int count = unordered, total;
+
+	GASPI_CHECK(gaspi_allreduce(&count,
+	                            &total,
+	                            1,
+	                            GASPI_OP_SUM,
+	                            GASPI_TYPE_INT,
+	                            GASPI_GROUP_ALL,
+	                            GASPI_BLOCK));
+	if (unordered > 0) {
+		fprintf(stderr,
+		        "%d payloads incomplete when their last byte arrived, "
+		        "writes are not ordered!\n",
+		        unordered);
+	}
+	return total == 0;
+}
+
+void delivery_mark(const gaspi_segment_id_t segment_id,
+                   const gaspi_offset_t offset,
+                   const unsigned char token) {
+	gaspi_pointer_t ptr;
+
+	GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+	__atomic_store_n((unsigned char*) ptr + offset, token, __ATOMIC_RELEASE);
+}
+
+void delivery_poll(const gaspi_segment_id_t segment_id,
+                   const gaspi_offset_t offset,
+                   const unsigned char token) {
+	gaspi_pointer_t ptr;
+	const unsigned char* flag;
+
+	GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+	flag = (const unsigned char*) ptr + offset;
+	while (__atomic_load_n(flag, __ATOMIC_ACQUIRE) != token) {
+	}
+}
@@ -0,0 +1,41 @@
+#ifndef __UTIL_DELIVERY_H__
+#define __UTIL_DELIVERY_H__
+#include <GASPI.h>
+#include <stddef.h>
+
+/*
+ * How the receiver of the notification benchmarks detects the arrival of a
+ * payload. --delivery notify,poll measures every size once per listed mode
+ * (see util_sweep): notify waits in gaspi_notify_waitsome, poll spins on the
+ * last byte of the payload, which the sender sets to a token and the
+ * receiver clears once it has seen it:
+ *   delivery_mark(segment_id, offset + size - 1, DELIVERY_PING);
+ *   delivery_poll(segment_id, offset + size - 1, DELIVERY_PING);
+ * Polling relies on the last byte being placed last, which GASPI does not
+ * guarantee, so verified iterations check the payload as soon as the token
+ * has been seen and count the incomplete ones for delivery_ordered, which
+ * the ranks call after the timed loop. Only benchmarks calling
+ * delivery_enable() before parsing their options accept --delivery.
+ */
+#define DELIVERY_PING 1
+#define DELIVERY_PONG 2
+
+enum delivery_mode { DELIVERY_NOTIFY = 0, DELIVERY_POLL };
+
+void delivery_enable(void);
+int delivery_enabled(void);
+int delivery_parse(const char* list);
+int delivery_active(void);
+int delivery_polls(void);
+int delivery_configs(void);
+void delivery_select(const int config);
+enum delivery_mode delivery_mode(void);
+const char* delivery_name(void);
+int delivery_ordered(const int unordered);
+void delivery_mark(const gaspi_segment_id_t segment_id,
+                   const gaspi_offset_t offset,
+                   const unsigned char token);
+void delivery_poll(const gaspi_segment_id_t segment_id,
+                   const gaspi_offset_t offset,
+                   const unsigned char token);
+#endif
@@ -0,0 +1,49 @@
+#include "util_hosts.h"
+#include <unistd.h>
+#include "benchdefs.h"
+#include "check.h"
+#include "util.h"
+#include "util_memory.h"
+
+// every rank writes its name to all others, notification i is rank i's
+char* hosts_gather(const gaspi_rank_t my_id, const gaspi_rank_t num_pes) {
+	const gaspi_queue_id_t q_id = 0;
+	gaspi_notification_id_t first;
+	gaspi_notification_t value;
+	gaspi_pointer_t ptr;
+	char* hosts;
+	gaspi_rank_t r;
+	int received;
+
+	allocate_gaspi_memory_initialized(TEMPORARY_SEGMENT_ID,
+	                                  num_pes * HOSTS_NAME_LENGTH);
+	GASPI_CHECK(gaspi_segment_ptr(TEMPORARY_SEGMENT_ID, &ptr));
+	gethostname((char*) ptr + my_id * HOSTS_NAME_LENGTH,
+	            HOSTS_NAME_LENGTH - 1);
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+	for (r = 0; r < num_pes; ++r) {
+		if (r == my_id) {
+			continue;
+		}
+		GASPI_CHECK(gaspi_write_notify(TEMPORARY_SEGMENT_ID,
+		                               my_id * HOSTS_NAME_LENGTH,
+		                               r,
+		                               TEMPORARY_SEGMENT_ID,
+		                               my_id * HOSTS_NAME_LENGTH,
+		                               HOSTS_NAME_LENGTH,
+		                               my_id,
+		                               1,
+		                               q_id,
+		                               GASPI_BLOCK));
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	}
+	for (received = 1; received < num_pes; ++received) {
+		GASPI_CHECK(gaspi_notify_waitsome(
+		    TEMPORARY_SEGMENT_ID, 0, num_pes, &first, GASPI_BLOCK));
+		GASPI_CHECK(gaspi_notify_reset(TEMPORARY_SEGMENT_ID, first, &value));
+	}
+	hosts = malloc(num_pes * HOSTS_NAME_LENGTH);
+	memcpy(hosts, ptr, num_pes * HOSTS_NAME_LENGTH);
+	free_gaspi_memory(TEMPORARY_SEGMENT_ID);
+	return hosts;
+}
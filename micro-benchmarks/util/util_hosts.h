@@ -0,0 +1,13 @@
+#ifndef __UTIL_HOSTS_H__
+#define __UTIL_HOSTS_H__
+#include <GASPI.h>
+
+/*
+ * Hostnames of all ranks, for the node-aware pairings and the metadata of
+ * --json. The name of rank i starts at hosts[i * HOSTS_NAME_LENGTH] and is
+ * zero terminated; the caller frees the array.
+ */
+#define HOSTS_NAME_LENGTH 64
+
+char* hosts_gather(const gaspi_rank_t my_id, const gaspi_rank_t num_pes);
+#endif
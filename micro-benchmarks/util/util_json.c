@@ -0,0 +1,311 @@
+#include "util_json.h"
+#include <math.h>
+#include "GASPI_Ext.h"
+#include "check.h"
+#include "stopwatch.h"
+#include "util_delivery.h"
+#include "util_hosts.h"
+#include "util_offsets.h"
+#include "util_perf.h"
+#include "util_placement.h"
+#include "util_stripe.h"
+#include "util_sweep.h"
+#include "util_sync.h"
+
+// indexed by enum benchmark_type and enum benchmark_subtype
+static const char* const type_names[] = {"collective",
+                                         "passive",
+                                         "onesided",
+                                         "atomic",
+                                         "notify",
+                                         "driver",
+                                         "threaded",
+                                         "multipair"};
+static const char* const subtype_names[] = {"bw",
+                                            "lat",
+                                            "allreduce",
+                                            "barrier",
+                                            "rate",
+                                            "pingpong",
+                                            "strided",
+                                            "oneway",
+                                            "segment",
+                                            "overlap"};
+static const char* const network_names[] = {
+    "GASPI_IB", "GASPI_ROCE", "GASPI_ETHERNET", "GASPI_GEMINI", "GASPI_ARIES"};
+
+// the system object, only known on rank 0
+static char* system_json = NULL;
+
+static void print_escaped(FILE* f, const char* s) {
+	if (s == NULL) {
+		fprintf(f, "null");
+		return;
+	}
+	fputc('"', f);
+	for (; *s != '\0'; ++s) {
+		if (*s == '"' || *s == '\\') {
+			fprintf(f, "\\%c", *s);
+		}
+		else if ((unsigned char) *s < 0x20) {
+			fprintf(f, "\\u%04x", (unsigned char) *s);
+		}
+		else {
+			fputc(*s, f);
+		}
+	}
+	fputc('"', f);
+}
+
+// JSON has no representation for NaN and infinity
+static void print_number(FILE* f, const double value) {
+	if (isfinite(value)) {
+		fprintf(f, "%.*f", FLOAT_PRECISION, value);
+	}
+	else {
+		fprintf(f, "null");
+	}
+}
+
+static void print_gaspi_limits(FILE* f) {
+	float version = 0.0f;
+	gaspi_number_t group_max, segment_max, queue_num, queue_size_max, queue_max,
+	    notification_num, allreduce_max_elem;
+	gaspi_size_t transfer_size_max, passive_transfer_size_max,
+	    allreduce_user_buf_size;
+	gaspi_atomic_value_t atomic_max_value;
+	gaspi_network_t network;
+
+	GASPI_CHECK(gaspi_group_max(&group_max));
+	GASPI_CHECK(gaspi_segment_max(&segment_max));
+	GASPI_CHECK(gaspi_queue_num(&queue_num));
+	GASPI_CHECK(gaspi_queue_size_max(&queue_size_max));
+	GASPI_CHECK(gaspi_queue_max(&queue_max));
+	GASPI_CHECK(gaspi_transfer_size_max(&transfer_size_max));
+	GASPI_CHECK(gaspi_notification_num(&notification_num));
+	GASPI_CHECK(gaspi_passive_transfer_size_max(&passive_transfer_size_max));
+	GASPI_CHECK(gaspi_atomic_max(&atomic_max_value));
+	GASPI_CHECK(gaspi_allreduce_buf_size(&allreduce_user_buf_size));
+	GASPI_CHECK(gaspi_allreduce_elem_max(&allreduce_max_elem));
+	GASPI_CHECK(gaspi_network_type(&network));
+	GASPI_CHECK(gaspi_version(&version));
+
+	fprintf(f, "\"gaspi\":{\"version\":%f,\"network\":", version);
+	print_escaped(f,
+	              (unsigned) network < 5 ? network_names[network] : "unknown");
+	fprintf(f,
+	        ",\"group_max\":%u,\"segment_max\":%u,\"queue_num\":%u,"
+	        "\"queue_size_max\":%u,\"queue_max\":%u,\"transfer_size_max\":%lu,"
+	        "\"notification_num\":%u,\"passive_transfer_size_max\":%lu,"
+	        "\"atomic_max\":%lu,\"allreduce_buf_size\":%lu,"
+	        "\"allreduce_elem_max\":%u}",
+	        group_max,
+	        segment_max,
+	        queue_num,
+	        queue_size_max,
+	        queue_max,
+	        (unsigned long) transfer_size_max,
+	        notification_num,
+	        (unsigned long) passive_transfer_size_max,
+	        (unsigned long) atomic_max_value,
+	        (unsigned long) allreduce_user_buf_size,
+	        allreduce_max_elem);
+}
+
+/*
+ * Collective, called by print_header. Queries everything that does not
+ * change during the run once, the driver prints several headers.
+ */
+void json_collect_metadata(void) {
+	gaspi_rank_t my_id, num_pes, i;
+	gaspi_float cpu_mhz;
+	char* hosts;
+	size_t length;
+	FILE* f;
+
+	if (system_json != NULL) {
+		return;
+	}
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+	hosts = hosts_gather(my_id, num_pes);
+	if (my_id != 0) {
+		free(hosts);
+		// mark the metadata as collected
+		system_json = malloc(1);
+		system_json[0] = '\0';
+		return;
+	}
+	GASPI_CHECK(gaspi_cpu_frequency(&cpu_mhz));
+
+	f = open_memstream(&system_json, &length);
+	fprintf(f, "{\"ranks\":%u,\"hosts\":[", num_pes);
+	for (i = 0; i < num_pes; ++i) {
+		if (i > 0) {
+			fputc(',', f);
+		}
+		print_escaped(f, hosts + i * HOSTS_NAME_LENGTH);
+	}
+	fprintf(f, "],\"cpu_mhz\":%f,\"timer\":", cpu_mhz);
+	print_escaped(f, stopwatch_name());
+	fprintf(f, ",\"timer_overhead_ns\":");
+	print_number(f, stopwatch_overhead);
+	fputc(',', f);
+	print_gaspi_limits(f);
+	fputc('}', f);
+	fclose(f);
+	free(hosts);
+}
+
+static void print_options(FILE* f) {
+	fprintf(f, "{\"type\":");
+	print_escaped(f, type_names[options.type]);
+	fprintf(f, ",\"subtype\":");
+	print_escaped(f, subtype_names[options.subtype]);
+	fprintf(f,
+	        ",\"window_size\":%d,\"iterations\":%d,\"warmup_iterations\":%d,"
+	        "\"min_message_size\":%zu,\"max_message_size\":%zu,"
+	        "\"single_buffer\":%d,\"verify\":%d,\"timer\":%d,"
+	        "\"streaming\":%d,\"adaptive\":%d,\"max_iterations\":%d,"
+	        "\"ci_width\":%f,\"time_budget\":%f,\"memory_mode\":",
+	        options.window_size,
+	        options.iterations,
+	        options.skip,
+	        options.min_message_size,
+	        options.max_message_size,
+	        options.single_buffer,
+	        options.verify,
+	        options.gaspi_timer,
+	        options.streaming,
+	        options.adaptive,
+	        options.max_iterations,
+	        options.ci_width,
+	        options.time_budget);
+	print_escaped(f, options.memory_mode);
+	fprintf(f, ",\"kernels\":");
+	print_escaped(f, options.kernels);
+	fprintf(f, ",\"raw_file\":");
+	print_escaped(f, options.raw_file);
+	fprintf(f, ",\"cpu_list\":");
+	print_escaped(f, options.cpu_list);
+	fprintf(f, ",\"numa_node\":");
+	print_escaped(f, options.numa_node);
+	fprintf(f, ",\"numa_sweep\":%d", options.numa_sweep);
+	fprintf(f, ",\"hugepages\":");
+	print_escaped(f, options.hugepages);
+	fprintf(f, ",\"random_offsets\":%zu", options.offset_span);
+	fprintf(f,
+	        ",\"cold_cache\":%zu,\"cold_stride\":%zu",
+	        options.cold_footprint,
+	        options.cold_stride);
+	fprintf(f,
+	        ",\"threads\":%d,\"queues\":%d",
+	        options.threads,
+	        options.queues);
+	fprintf(f, ",\"pairing\":");
+	print_escaped(f, options.pairing);
+	fprintf(f, ",\"queue_depth\":%d", options.queue_depth);
+	fprintf(f, ",\"compute_time\":%f", options.compute_time);
+	fprintf(f, ",\"polling\":%d", options.polling);
+	fprintf(f, ",\"delivery\":");
+	print_escaped(f, options.delivery);
+	fprintf(f, ",\"verify_every\":%d", options.verify_every);
+	fputc('}', f);
+}
+
+void json_record_begin(void) {
+	fprintf(stdout, "{\"benchmark\":");
+	print_escaped(stdout, options.name);
+	fprintf(stdout, ",\"options\":");
+	print_options(stdout);
+	fprintf(stdout,
+	        ",\"system\":%s",
+	        system_json != NULL && system_json[0] != '\0' ? system_json
+	                                                       : "null");
+}
+
+void json_int(const char* key, const long long value) {
+	fputc(',', stdout);
+	print_escaped(stdout, key);
+	fprintf(stdout, ":%lld", value);
+}
+
+void json_double(const char* key, const double value) {
+	fputc(',', stdout);
+	print_escaped(stdout, key);
+	fputc(':', stdout);
+	print_number(stdout, value);
+}
+
+void json_string(const char* key, const char* value) {
+	fputc(',', stdout);
+	print_escaped(stdout, key);
+	fputc(':', stdout);
+	print_escaped(stdout, value);
+}
+
+// the statistics columns and the row tail of print_percentiles
+void json_statistics(const char* metric,
+                     const struct statistics_t* statistics) {
+	const char* const names[] = {"min",
+	                             "max",
+	                             "avg",
+	                             "median",
+	                             "var",
+	                             "std",
+	                             "p90",
+	                             "p99",
+	                             "p99.9",
+	                             "p99.99"};
+	const double values[] = {statistics->min,
+	                         statistics->max,
+	                         statistics->avg,
+	                         statistics->median,
+	                         statistics->var,
+	                         statistics->std,
+	                         statistics->p90,
+	                         statistics->p99,
+	                         statistics->p999,
+	                         statistics->p9999};
+	char key[FIELD_WIDTH];
+	int i;
+
+	for (i = 0; i < 10; ++i) {
+		snprintf(key, sizeof(key), "%s_%s", names[i], metric);
+		json_double(key, values[i]);
+	}
+	if (options.adaptive) {
+		snprintf(key, sizeof(key), "ci_low_%s", metric);
+		json_double(key, statistics->ci_low);
+		snprintf(key, sizeof(key), "ci_high_%s", metric);
+		json_double(key, statistics->ci_high);
+	}
+	json_int("samples", statistics->samples);
+	for (i = 0; i < perf_num_counters(); ++i) {
+		json_double(perf_counter_name(i), statistics->counters[i]);
+	}
+	if (placement_node() != PLACEMENT_ANY) {
+		json_int("numa_node", placement_node());
+		json_int("nic_local", placement_nic_local());
+	}
+	if (sweep_windows()) {
+		json_int("window_size", options.window_size);
+	}
+	if (stripe_active()) {
+		json_int("queues", stripe_queues());
+		json_int("chunks", stripe_chunks());
+	}
+	if (offsets_configs() > 1) {
+		json_string("cache", offsets_cold() ? "cold" : "hot");
+	}
+	if (delivery_active()) {
+		json_string("delivery", delivery_name());
+	}
+	if (pair_sync_enabled()) {
+		json_double("pair_sync_us", pair_sync_cost() * 1e-3);
+	}
+}
+
+void json_record_end(void) {
+	fprintf(stdout, "}\n");
+}
@@ -0,0 +1,23 @@
+#ifndef __UTIL_JSON_H__
+#define __UTIL_JSON_H__
+#include "util.h"
+
+/*
+ * NDJSON output (--json): every result is a single line holding one JSON
+ * object with the benchmark name, the options, the system metadata and the
+ * result fields:
+ *   json_record_begin();
+ *   json_int("msg_size", size);
+ *   json_statistics("lat", &statistics);
+ *   json_record_end();
+ * The column names of the CSV output are used as keys.
+ */
+
+void json_collect_metadata(void);
+void json_record_begin(void);
+void json_int(const char* key, const long long value);
+void json_double(const char* key, const double value);
+void json_string(const char* key, const char* value);
+void json_statistics(const char* metric, const struct statistics_t* statistics);
+void json_record_end(void);
+#endif
@@ -1,11 +1,106 @@
 #include "util_memory.h"
+#include <time.h>
 #include "check.h"
+#include "util.h"
+#include "util_placement.h"
+
+/*
+ * Segments outlive free_gaspi_memory and are reused by the next allocation
+ * with the same id that fits, unless --no-arena is given. A segment is only
+ * registered again when it is too small or placed on another NUMA node.
+ */
+struct arena_segment_t {
+	size_t capacity; // 0 if the segment does not exist
+	int node;
+	void* placed; // memory of a segment over placed memory, see util_placement
+};
+
+static struct arena_segment_t arena[256];
+
+struct registration_t registration;
+
+static double now(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+static void delete_segment(const gaspi_segment_id_t id) {
+	const double start = now();
+
+	GASPI_CHECK(gaspi_segment_delete(id));
+	registration.time += now() - start;
+	if (arena[id].placed != NULL) {
+		placement_free(arena[id].placed, arena[id].capacity);
+		arena[id].placed = NULL;
+	}
+	arena[id].capacity = 0;
+}
+
+static void create_segment(const gaspi_segment_id_t id,
+                           const size_t size,
+                           const gaspi_alloc_t alloc_policy) {
+	void* ptr = placement_alloc(size);
+	const double start = now();
+
+	if (ptr == NULL) {
+		GASPI_CHECK(gaspi_segment_create(
+		    id, size, GASPI_GROUP_ALL, GASPI_BLOCK, alloc_policy));
+	}
+	else {
+		// the placed memory is zeroed already
+		GASPI_CHECK(
+		    gaspi_segment_use(id, ptr, size, GASPI_GROUP_ALL, GASPI_BLOCK, 0));
+	}
+	registration.time += now() - start;
+	++registration.segments;
+	registration.bytes += size;
+	arena[id].capacity = size;
+	arena[id].node = placement_node();
+	arena[id].placed = ptr;
+}
+
+// gaspi_segment_create clears the notifications, a reused segment must too
+static void reset_notifications(const gaspi_segment_id_t id) {
+	gaspi_number_t notification_num, n;
+	gaspi_notification_t value;
+
+	GASPI_CHECK(gaspi_notification_num(&notification_num));
+	for (n = 0; n < notification_num; ++n) {
+		GASPI_CHECK(gaspi_notify_reset(id, n, &value));
+	}
+}
+
+// returns 1 if an existing segment is reused
+static int acquire_segment(const gaspi_segment_id_t id,
+                           const size_t size,
+                           const gaspi_alloc_t alloc_policy) {
+	if (arena[id].capacity > 0) {
+		if (arena[id].capacity >= size &&
+		    arena[id].node == placement_node()) {
+			reset_notifications(id);
+			return 1;
+		}
+		delete_segment(id);
+	}
+	create_segment(id, size, alloc_policy);
+	return 0;
+}
+
+/*
+ * Registers the largest footprint of a segment before the sweep, so that the
+ * allocations of the single sizes only hand out its first bytes.
+ */
+void reserve_gaspi_memory(const gaspi_segment_id_t id, const size_t size) {
+	if (options.arena) {
+		acquire_segment(id, size, GASPI_MEM_UNINITIALIZED);
+	}
+}
 
 void allocate_gaspi_memory(const gaspi_segment_id_t id,
                            const size_t size,
                            const char c) {
-	GASPI_CHECK(gaspi_segment_create(
-	    id, size, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_UNINITIALIZED));
+	acquire_segment(id, size, GASPI_MEM_UNINITIALIZED);
 	void* ptr;
 	GASPI_CHECK(gaspi_segment_ptr(id, &ptr));
 	memset(ptr, c, size);
@@ -15,13 +110,20 @@ void allocate_gaspi_memory(const gaspi_segment_id_t id,
 // allocate zeroed memory segments
 void allocate_gaspi_memory_initialized(const gaspi_segment_id_t id,
                                        const size_t size) {
-	GASPI_CHECK(gaspi_segment_create(
-	    id, size, GASPI_GROUP_ALL, GASPI_BLOCK, GASPI_MEM_INITIALIZED));
+	void* ptr;
+
+	if (acquire_segment(id, size, GASPI_MEM_INITIALIZED)) {
+		GASPI_CHECK(gaspi_segment_ptr(id, &ptr));
+		memset(ptr, 0, size);
+		GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+	}
 }
 
 void free_gaspi_memory(const gaspi_segment_id_t id) {
 	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
-	GASPI_CHECK(gaspi_segment_delete(id));
+	if (!options.arena) {
+		delete_segment(id);
+	}
 }
 
 void allocate_memory(void** buffer, const size_t size) {
@@ -6,6 +6,16 @@
 #include <string.h>
 #include <unistd.h>
 
+// segment registrations of this rank, see print_registration
+struct registration_t {
+	int segments;
+	size_t bytes;
+	double time; // ns spent in segment creation and deletion
+};
+
+extern struct registration_t registration;
+
+void reserve_gaspi_memory(const gaspi_segment_id_t id, const size_t size);
 void allocate_gaspi_memory(const gaspi_segment_id_t,
                            const size_t,
                            const char c);
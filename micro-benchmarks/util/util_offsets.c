@@ -0,0 +1,123 @@
+#include "util_offsets.h"
+#include <stdlib.h>
+#include "util.h"
+
+struct offsets_t {
+	unsigned long long state; // xorshift64*, the same seed on every rank
+	size_t size;              // message size the slots were computed for
+	unsigned long long slots; // aligned offsets in the span
+	int pass;                 // OFFSETS_COLD rotates through the pool
+	size_t cursor;            // next offset of the rotation
+};
+
+static struct offsets_t offsets = {
+    0x9e3779b97f4a7c15ULL, 0, 0, OFFSETS_NONE, 0};
+
+// a number of bytes with an optional K, M or G suffix (binary), 0 if there
+// is no number, end points behind it
+static unsigned long long parse_bytes(const char* arg, char** end) {
+	unsigned long long bytes = strtoull(arg, end, 10);
+
+	if (*end == arg) {
+		return 0;
+	}
+	switch (**end) {
+		case 'K':
+			bytes <<= 10;
+			++*end;
+			break;
+		case 'M':
+			bytes <<= 20;
+			++*end;
+			break;
+		case 'G':
+			bytes <<= 30;
+			++*end;
+			break;
+	}
+	return bytes;
+}
+
+int offsets_parse(const char* span) {
+	char* end;
+	unsigned long long bytes = parse_bytes(span, &end);
+
+	if (*end != '\0' || bytes == 0) {
+		return OPTIONS_BAD_USAGE;
+	}
+	options.offset_span = bytes;
+	return OPTIONS_OKAY;
+}
+
+int offsets_parse_cold(const char* spec) {
+	char* end;
+	unsigned long long footprint = parse_bytes(spec, &end);
+	unsigned long long stride = OFFSETS_DEFAULT_STRIDE;
+
+	if (*end == ':') {
+		stride = parse_bytes(end + 1, &end);
+	}
+	if (*end != '\0' || footprint == 0 || stride == 0) {
+		return OPTIONS_BAD_USAGE;
+	}
+	options.cold_footprint = footprint;
+	options.cold_stride = stride;
+	return OPTIONS_OKAY;
+}
+
+// passes of every size, hot and cold with --cold-cache
+int offsets_configs(void) {
+	return options.cold_footprint > 0 ? 2 : 1;
+}
+
+// OFFSETS_NONE outside of the sweep
+void offsets_select(const int pass) {
+	offsets.pass = pass;
+	offsets.cursor = 0;
+}
+
+int offsets_cold(void) {
+	return offsets.pass == OFFSETS_COLD;
+}
+
+// segment size needed for bytes at fixed offsets, for the random span or for
+// the rotation of the current pass, of any pass outside of the sweep
+size_t offsets_footprint(const size_t bytes) {
+	size_t footprint = bytes;
+
+	if (options.offset_span > footprint) {
+		footprint = options.offset_span;
+	}
+	if (offsets.pass != OFFSETS_HOT && options.cold_footprint > footprint) {
+		footprint = options.cold_footprint;
+	}
+	return footprint;
+}
+
+gaspi_offset_t offsets_next(const size_t size, const gaspi_offset_t fixed) {
+	unsigned long long random;
+	gaspi_offset_t offset;
+
+	if (offsets.pass == OFFSETS_COLD) {
+		if (offsets.cursor + size > options.cold_footprint) {
+			offsets.cursor = 0;
+		}
+		offset = offsets.cursor;
+		offsets.cursor += (size + options.cold_stride - 1) /
+		                  options.cold_stride * options.cold_stride;
+		return offset;
+	}
+	if (options.offset_span == 0) {
+		return fixed;
+	}
+	if (size != offsets.size) {
+		offsets.size = size;
+		offsets.slots = options.offset_span / size;
+	}
+	offsets.state ^= offsets.state >> 12;
+	offsets.state ^= offsets.state << 25;
+	offsets.state ^= offsets.state >> 27;
+	random = offsets.state * 2685821657736338717ULL;
+	// scaled to [0, slots) by a multiplication instead of a division
+	return ((unsigned __int128) random * offsets.slots >> 64) * size;
+}
@@ -0,0 +1,33 @@
+#ifndef __UTIL_OFFSETS_H__
+#define __UTIL_OFFSETS_H__
+#include <GASPI.h>
+#include <stddef.h>
+
+/*
+ * Access offsets of the one-sided benchmarks. With --random-offsets SPAN the
+ * segments span SPAN bytes and every message goes to a uniformly random
+ * offset in them, aligned to the message size, instead of its fixed offset:
+ *   offset = offsets_next(size, j * size);
+ * so that the address translation caches of the NIC and the IOMMU miss.
+ *
+ * With --cold-cache FOOTPRINT[:STRIDE] the sweep measures every size twice,
+ * first hot at the fixed offsets and right after cold: the messages rotate
+ * through segments of FOOTPRINT bytes, each starting STRIDE-aligned right
+ * after the previous one, so that no message finds its lines in a cache.
+ * Only the cold pass needs the whole footprint, outside of the sweep
+ * offsets_footprint covers both passes.
+ */
+#define OFFSETS_DEFAULT_STRIDE 4096
+
+#define OFFSETS_NONE -1
+#define OFFSETS_HOT 0
+#define OFFSETS_COLD 1
+
+int offsets_parse(const char* span);
+int offsets_parse_cold(const char* spec);
+int offsets_configs(void);
+void offsets_select(const int pass);
+int offsets_cold(void);
+size_t offsets_footprint(const size_t bytes);
+gaspi_offset_t offsets_next(const size_t size, const gaspi_offset_t fixed);
+#endif
@@ -0,0 +1,295 @@
+#include "util_pairs.h"
+#include "benchdefs.h"
+#include "check.h"
+#include "util.h"
+#include "util_hosts.h"
+#include "util_memory.h"
+
+enum pairing_mode {
+	PAIRING_BLOCK = 0,
+	PAIRING_INTRA,
+	PAIRING_INTER,
+	PAIRING_LIST
+};
+
+struct pairs_t {
+	enum pairing_mode mode;
+	const char* list;
+	gaspi_rank_t* first; // senders
+	gaspi_rank_t* second;
+	int count;
+	int index; // pair of the calling rank, PAIRS_NONE if it idles
+};
+
+static struct pairs_t pairs = {PAIRING_BLOCK, NULL, NULL, NULL, 0, PAIRS_NONE};
+
+// reads "A:B,C:D,...", returns the number of pairs or 0 if malformed
+static int parse_list(const char* list,
+                      gaspi_rank_t* first,
+                      gaspi_rank_t* second) {
+	const char* c = list;
+	char* end;
+	long a, b;
+	int n = 0;
+
+	while (*c != '\0') {
+		a = strtol(c, &end, 10);
+		if (end == c || *end != ':' || a < 0) {
+			return 0;
+		}
+		c = end + 1;
+		b = strtol(c, &end, 10);
+		if (end == c || (*end != ',' && *end != '\0') || b < 0 || a == b) {
+			return 0;
+		}
+		if (first != NULL) {
+			first[n] = (gaspi_rank_t) a;
+			second[n] = (gaspi_rank_t) b;
+		}
+		++n;
+		c = *end == ',' ? end + 1 : end;
+	}
+	return n;
+}
+
+int pairs_parse(const char* spec) {
+	if (strcmp(spec, "block") == 0) {
+		pairs.mode = PAIRING_BLOCK;
+	}
+	else if (strcmp(spec, "intra") == 0) {
+		pairs.mode = PAIRING_INTRA;
+	}
+	else if (strcmp(spec, "inter") == 0) {
+		pairs.mode = PAIRING_INTER;
+	}
+	else if (parse_list(spec, NULL, NULL) > 0) {
+		pairs.mode = PAIRING_LIST;
+		pairs.list = spec;
+	}
+	else {
+		return OPTIONS_BAD_USAGE;
+	}
+	return OPTIONS_OKAY;
+}
+
+static void add_pair(const gaspi_rank_t a, const gaspi_rank_t b) {
+	pairs.first[pairs.count] = a < b ? a : b;
+	pairs.second[pairs.count] = a < b ? b : a;
+	++pairs.count;
+}
+
+/*
+ * Groups the ranks by node in the order of their first rank: node[i] is the
+ * node of rank i, the ranks of node k are listed in rank order.
+ */
+static int group_nodes(const char* hosts,
+                       const gaspi_rank_t num_pes,
+                       int* node) {
+	int nodes = 0, i, j;
+
+	for (i = 0; i < num_pes; ++i) {
+		node[i] = -1;
+		for (j = 0; j < i; ++j) {
+			if (strncmp(hosts + i * HOSTS_NAME_LENGTH,
+			            hosts + j * HOSTS_NAME_LENGTH,
+			            HOSTS_NAME_LENGTH) == 0) {
+				node[i] = node[j];
+				break;
+			}
+		}
+		if (node[i] == -1) {
+			node[i] = nodes++;
+		}
+	}
+	return nodes;
+}
+
+// the k-th rank of node n, num_pes if the node has fewer ranks
+static gaspi_rank_t node_rank(const int* node,
+                              const gaspi_rank_t num_pes,
+                              const int n,
+                              const int k) {
+	gaspi_rank_t r;
+	int seen = 0;
+
+	for (r = 0; r < num_pes; ++r) {
+		if (node[r] == n && seen++ == k) {
+			return r;
+		}
+	}
+	return num_pes;
+}
+
+static int node_size(const int* node, const gaspi_rank_t num_pes, const int n) {
+	int size = 0, r;
+
+	for (r = 0; r < num_pes; ++r) {
+		size += node[r] == n;
+	}
+	return size;
+}
+
+static void pair_nodes(const gaspi_rank_t my_id, const gaspi_rank_t num_pes) {
+	char* hosts = hosts_gather(my_id, num_pes);
+	int* node = malloc(num_pes * sizeof(*node));
+	const int nodes = group_nodes(hosts, num_pes, node);
+	int n, k, half, size;
+
+	for (n = 0; n < nodes; ++n) {
+		if (pairs.mode == PAIRING_INTRA) {
+			half = node_size(node, num_pes, n) / 2;
+			for (k = 0; k < half; ++k) {
+				add_pair(node_rank(node, num_pes, n, k),
+				         node_rank(node, num_pes, n, k + half));
+			}
+		}
+		else if (n % 2 == 0 && n + 1 < nodes) {
+			size = node_size(node, num_pes, n);
+			if (node_size(node, num_pes, n + 1) < size) {
+				size = node_size(node, num_pes, n + 1);
+			}
+			for (k = 0; k < size; ++k) {
+				add_pair(node_rank(node, num_pes, n, k),
+				         node_rank(node, num_pes, n + 1, k));
+			}
+		}
+	}
+	free(node);
+	free(hosts);
+}
+
+// called once GASPI is initialized, collective
+void pairs_init(void) {
+	gaspi_rank_t my_id, num_pes, r;
+	int i, j;
+
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	GASPI_CHECK(gaspi_proc_num(&num_pes));
+	pairs.first = malloc(num_pes * sizeof(*pairs.first));
+	pairs.second = malloc(num_pes * sizeof(*pairs.second));
+	pairs.count = 0;
+	if (pairs.mode == PAIRING_BLOCK) {
+		for (r = 0; r < num_pes / 2; ++r) {
+			add_pair(r, r + num_pes / 2);
+		}
+	}
+	else if (pairs.mode == PAIRING_LIST) {
+		pairs.count = parse_list(pairs.list, NULL, NULL);
+		if (pairs.count > num_pes / 2) {
+			fprintf(stderr, "More pairs in --pairing than ranks\n");
+			exit(EXIT_FAILURE);
+		}
+		parse_list(pairs.list, pairs.first, pairs.second);
+	}
+	else {
+		pair_nodes(my_id, num_pes);
+	}
+
+	pairs.index = PAIRS_NONE;
+	for (i = 0; i < pairs.count; ++i) {
+		for (j = 0; j < i; ++j) {
+			if (pairs.first[i] == pairs.first[j] ||
+			    pairs.first[i] == pairs.second[j] ||
+			    pairs.second[i] == pairs.first[j] ||
+			    pairs.second[i] == pairs.second[j]) {
+				fprintf(stderr, "Rank in more than one pair of --pairing\n");
+				exit(EXIT_FAILURE);
+			}
+		}
+		if (pairs.first[i] >= num_pes || pairs.second[i] >= num_pes) {
+			fprintf(stderr, "Rank of --pairing out of range\n");
+			exit(EXIT_FAILURE);
+		}
+		if (pairs.first[i] == my_id || pairs.second[i] == my_id) {
+			pairs.index = i;
+		}
+	}
+	if (pairs.count == 0) {
+		fprintf(stderr, "No rank pairs found for the --pairing mode\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+int pairs_count(void) {
+	return pairs.count;
+}
+
+int pairs_index(void) {
+	return pairs.index;
+}
+
+int pairs_sender(void) {
+	gaspi_rank_t my_id;
+
+	if (pairs.index == PAIRS_NONE) {
+		return 0;
+	}
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	return pairs.first[pairs.index] == my_id;
+}
+
+gaspi_rank_t pairs_partner(void) {
+	gaspi_rank_t my_id;
+
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	return pairs.first[pairs.index] == my_id ? pairs.second[pairs.index]
+	                                          : pairs.first[pairs.index];
+}
+
+gaspi_rank_t pairs_first(const int pair) {
+	return pairs.first[pair];
+}
+
+gaspi_rank_t pairs_second(const int pair) {
+	return pairs.second[pair];
+}
+
+/*
+ * Collects size bytes from the sender of every pair, returns them in pair
+ * order on rank 0 (to be freed) and NULL on the other ranks. Collective.
+ */
+void* pairs_gather(const void* value, const size_t size) {
+	const gaspi_queue_id_t q_id = 0;
+	gaspi_notification_id_t first;
+	gaspi_notification_t notification;
+	gaspi_pointer_t ptr;
+	gaspi_rank_t my_id;
+	void* values = NULL;
+	int expected = pairs.count, i;
+
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	allocate_gaspi_memory_initialized(TEMPORARY_SEGMENT_ID,
+	                                  pairs.count * size);
+	GASPI_CHECK(gaspi_segment_ptr(TEMPORARY_SEGMENT_ID, &ptr));
+	if (pairs_sender()) {
+		memcpy((char*) ptr + pairs.index * size, value, size);
+		if (my_id != 0) {
+			GASPI_CHECK(gaspi_write_notify(TEMPORARY_SEGMENT_ID,
+			                               pairs.index * size,
+			                               0,
+			                               TEMPORARY_SEGMENT_ID,
+			                               pairs.index * size,
+			                               size,
+			                               pairs.index,
+			                               1,
+			                               q_id,
+			                               GASPI_BLOCK));
+			GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+		}
+	}
+	if (my_id == 0) {
+		if (pairs_sender()) {
+			--expected;
+		}
+		for (i = 0; i < expected; ++i) {
+			GASPI_CHECK(gaspi_notify_waitsome(
+			    TEMPORARY_SEGMENT_ID, 0, pairs.count, &first, GASPI_BLOCK));
+			GASPI_CHECK(gaspi_notify_reset(
+			    TEMPORARY_SEGMENT_ID, first, &notification));
+		}
+		values = malloc(pairs.count * size);
+		memcpy(values, ptr, pairs.count * size);
+	}
+	free_gaspi_memory(TEMPORARY_SEGMENT_ID);
+	return values;
+}
@@ -0,0 +1,26 @@
+#ifndef __UTIL_PAIRS_H__
+#define __UTIL_PAIRS_H__
+#include <GASPI.h>
+#include <stddef.h>
+
+/*
+ * Rank pairs of the multi-pair benchmarks, selected with --pairing:
+ *   block    rank i with rank i + n / 2 (default)
+ *   intra    the first half of the ranks of every node with the second half
+ *   inter    the k-th rank of a node with the k-th rank of the next node
+ *   A:B,...  explicit pairs, A is the sender
+ * The lower rank of a generated pair is its sender. Ranks without a pair
+ * only take part in the collective calls.
+ */
+#define PAIRS_NONE -1
+
+int pairs_parse(const char* spec);
+void pairs_init(void);
+int pairs_count(void);
+int pairs_index(void);
+int pairs_sender(void);
+gaspi_rank_t pairs_partner(void);
+gaspi_rank_t pairs_first(const int pair);
+gaspi_rank_t pairs_second(const int pair);
+void* pairs_gather(const void* value, const size_t size);
+#endif
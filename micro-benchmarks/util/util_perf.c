@@ -0,0 +1,239 @@
+#include "util_perf.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "util.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_HAVE_EVENTS
+#endif
+
+#if defined(PERF_HAVE_EVENTS) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PERF_HAVE_RDPMC
+#endif
+
+// --counters names and the column names of the output
+static const char* const event_options[] = {"cycles",
+                                            "instructions",
+                                            "cache-misses",
+                                            "dtlb-misses",
+                                            "page-faults",
+                                            "context-switches"};
+static const char* const event_columns[] = {"cycles",
+                                            "instructions",
+                                            "cache_misses",
+                                            "dtlb_misses",
+                                            "page_faults",
+                                            "context_switches"};
+
+#ifdef PERF_HAVE_EVENTS
+// perf_event_attr type and config, indexed like event_options
+static const unsigned event_types[] = {PERF_TYPE_HARDWARE,
+                                       PERF_TYPE_HARDWARE,
+                                       PERF_TYPE_HARDWARE,
+                                       PERF_TYPE_HW_CACHE,
+                                       PERF_TYPE_SOFTWARE,
+                                       PERF_TYPE_SOFTWARE};
+static const unsigned long long event_configs[] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_SW_PAGE_FAULTS,
+    PERF_COUNT_SW_CONTEXT_SWITCHES};
+#endif
+
+struct perf_counter_t {
+	int event; // index into event_options
+	int fd;
+	void* page; // perf_event_mmap_page for rdpmc, NULL if not mapped
+	unsigned long long start;
+	unsigned long long total;
+};
+
+struct perf_t {
+	struct perf_counter_t counters[PERF_MAX_COUNTERS];
+	int num_counters;
+	int requested[PERF_MAX_COUNTERS];
+	int num_requested;
+	unsigned long long regions;
+};
+
+static struct perf_t perf;
+
+// comma separated event names, see events
+int perf_parse(const char* list) {
+	const char* c = list;
+	size_t length;
+	int i;
+
+	perf.num_requested = 0;
+	while (*c != '\0') {
+		length = strcspn(c, ",");
+		for (i = 0; i < PERF_MAX_COUNTERS; ++i) {
+			if (strlen(event_options[i]) == length &&
+			    strncmp(event_options[i], c, length) == 0) {
+				break;
+			}
+		}
+		if (i == PERF_MAX_COUNTERS || perf.num_requested == PERF_MAX_COUNTERS) {
+			return OPTIONS_BAD_USAGE;
+		}
+		perf.requested[perf.num_requested++] = i;
+		c += c[length] == ',' ? length + 1 : length;
+	}
+	return perf.num_requested > 0 ? OPTIONS_OKAY : OPTIONS_BAD_USAGE;
+}
+
+#ifdef PERF_HAVE_EVENTS
+static int open_event(const int event,
+                      const int group,
+                      const int exclude_kernel) {
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = event_types[event];
+	attr.config = event_configs[event];
+	// the leader keeps the whole group on the PMU, so rdpmc always works
+	attr.pinned = group == -1;
+	attr.exclude_kernel = exclude_kernel;
+	attr.exclude_hv = 1;
+	return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+/*
+ * Opens the requested counters for the calling thread. Counters the kernel
+ * refuses (e.g. perf_event_paranoid) are dropped with a warning.
+ */
+void perf_open(void) {
+#ifdef PERF_HAVE_EVENTS
+	struct perf_counter_t* counter;
+	int i, group = -1;
+
+	for (i = 0; i < perf.num_requested; ++i) {
+		counter = &perf.counters[perf.num_counters];
+		counter->event = perf.requested[i];
+		counter->fd = open_event(counter->event, group, 0);
+		if (counter->fd < 0) {
+			counter->fd = open_event(counter->event, group, 1);
+		}
+		if (counter->fd < 0) {
+			fprintf(stderr,
+			        "Cannot open the %s counter, check "
+			        "/proc/sys/kernel/perf_event_paranoid\n",
+			        event_options[counter->event]);
+			continue;
+		}
+		counter->page = mmap(NULL,
+		                     sysconf(_SC_PAGESIZE),
+		                     PROT_READ,
+		                     MAP_SHARED,
+		                     counter->fd,
+		                     0);
+		if (counter->page == MAP_FAILED) {
+			counter->page = NULL;
+		}
+		if (group == -1) {
+			group = counter->fd;
+		}
+		++perf.num_counters;
+	}
+#else
+	if (perf.num_requested > 0) {
+		fprintf(stderr, "Event counters are not supported on this system\n");
+	}
+#endif
+}
+
+int perf_num_counters(void) {
+	return perf.num_counters;
+}
+
+const char* perf_counter_name(const int i) {
+	return event_columns[perf.counters[i].event];
+}
+
+#ifdef PERF_HAVE_EVENTS
+static unsigned long long read_counter(const struct perf_counter_t* counter) {
+	unsigned long long value = 0;
+#ifdef PERF_HAVE_RDPMC
+	volatile struct perf_event_mmap_page* pc = counter->page;
+	unsigned seq, index;
+	long long pmc;
+
+	// seqlock protocol of perf_event_mmap_page
+	while (pc != NULL) {
+		seq = pc->lock;
+		__sync_synchronize();
+		index = pc->index;
+		if (!pc->cap_user_rdpmc || index == 0) {
+			break;
+		}
+		pmc = __rdpmc(index - 1);
+		pmc <<= 64 - pc->pmc_width;
+		pmc >>= 64 - pc->pmc_width;
+		value = pc->offset + pmc;
+		__sync_synchronize();
+		if (pc->lock == seq) {
+			return value;
+		}
+	}
+#endif
+	if (read(counter->fd, &value, sizeof(value)) != sizeof(value)) {
+		return 0;
+	}
+	return value;
+}
+#endif
+
+void perf_start(void) {
+#ifdef PERF_HAVE_EVENTS
+	int i;
+
+	for (i = 0; i < perf.num_counters; ++i) {
+		perf.counters[i].start = read_counter(&perf.counters[i]);
+	}
+#endif
+}
+
+void perf_stop(void) {
+#ifdef PERF_HAVE_EVENTS
+	int i;
+
+	// in reverse order, the first counter is read closest to the timer
+	for (i = perf.num_counters - 1; i >= 0; --i) {
+		perf.counters[i].total +=
+		    read_counter(&perf.counters[i]) - perf.counters[i].start;
+	}
+	++perf.regions;
+#endif
+}
+
+// starts a new sample set
+void perf_reset(void) {
+	int i;
+
+	for (i = 0; i < perf.num_counters; ++i) {
+		perf.counters[i].total = 0;
+	}
+	perf.regions = 0;
+}
+
+// mean count per timed region since the last reset
+void perf_means(double* means) {
+	int i;
+
+	for (i = 0; i < perf.num_counters; ++i) {
+		means[i] = perf.regions > 0
+		               ? (double) perf.counters[i].total / perf.regions
+		               : 0;
+	}
+}
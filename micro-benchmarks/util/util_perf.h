@@ -0,0 +1,24 @@
+#ifndef __UTIL_PERF_H__
+#define __UTIL_PERF_H__
+
+/*
+ * Hardware and software event counters around the timed regions (--counters).
+ * stopwatch_start reads the counters before and stopwatch_stop after the
+ * timer, so the reads are not part of the measured time. The counts are
+ * accumulated per sample set and reported as mean per timed iteration next to
+ * the timing statistics of every message size.
+ *
+ * Counters are read in user space with rdpmc where the kernel allows it and
+ * with read() otherwise, e.g. for the software events.
+ */
+#define PERF_MAX_COUNTERS 6
+
+int perf_parse(const char* list);
+void perf_open(void);
+int perf_num_counters(void);
+const char* perf_counter_name(const int i);
+void perf_start(void);
+void perf_stop(void);
+void perf_reset(void);
+void perf_means(double* means);
+#endif
@@ -0,0 +1,422 @@
+#define _GNU_SOURCE
+#include "util_placement.h"
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "check.h"
+#include "util.h"
+
+#define BITS_PER_LONG (8 * sizeof(unsigned long))
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#define HUGE_2M (1UL << 21)
+#define HUGE_1G (1UL << 30)
+
+enum page_kind { PAGES_DEFAULT = 0, PAGES_2M, PAGES_1G, PAGES_THP };
+
+struct placement_t {
+	int node; // resolved node of the segment memory, PLACEMENT_ANY if unset
+	int nic;  // node of the InfiniBand device, PLACEMENT_ANY if unknown
+	enum page_kind pages;
+	cpu_set_t cpus; // cores of the rank, handed out to its threads
+};
+
+static struct placement_t placement = {
+    PLACEMENT_ANY, PLACEMENT_ANY, PAGES_DEFAULT};
+
+/*
+ * Adds the comma separated numbers and ranges between list and end, e.g.
+ * "0-3,8", to set. Also used for node lists, which have the same limit.
+ */
+static int parse_ranges(const char* list, const char* end, cpu_set_t* set) {
+	long first, last;
+	char* next;
+
+	CPU_ZERO(set);
+	while (list < end) {
+		first = strtol(list, &next, 10);
+		if (next == list || first < 0) {
+			return OPTIONS_BAD_USAGE;
+		}
+		last = first;
+		if (*next == '-') {
+			list = next + 1;
+			last = strtol(list, &next, 10);
+			if (next == list || last < first) {
+				return OPTIONS_BAD_USAGE;
+			}
+		}
+		if (last >= CPU_SETSIZE || next > end) {
+			return OPTIONS_BAD_USAGE;
+		}
+		for (; first <= last; ++first) {
+			CPU_SET(first, set);
+		}
+		if (next < end && *next != ',') {
+			return OPTIONS_BAD_USAGE;
+		}
+		list = next + 1;
+	}
+	return CPU_COUNT(set) > 0 ? OPTIONS_OKAY : OPTIONS_BAD_USAGE;
+}
+
+// the group of the colon separated cpu list for rank, NULL if malformed
+static const char* cpu_group(const char* list,
+                             const int rank,
+                             cpu_set_t* set) {
+	const char* group = list;
+	const char* end;
+	int groups = 1, i;
+
+	for (end = list; *end != '\0'; ++end) {
+		groups += *end == ':';
+	}
+	for (i = 0; i < rank % groups; ++i) {
+		group = strchr(group, ':') + 1;
+	}
+	end = strchr(group, ':');
+	if (end == NULL) {
+		end = group + strlen(group);
+	}
+	return parse_ranges(group, end, set) == OPTIONS_OKAY ? group : NULL;
+}
+
+int placement_parse_cpus(const char* list) {
+	cpu_set_t set;
+	const char* c;
+	int groups = 1, i;
+
+	for (c = list; *c != '\0'; ++c) {
+		groups += *c == ':';
+	}
+	for (i = 0; i < groups; ++i) {
+		if (cpu_group(list, i, &set) == NULL) {
+			return OPTIONS_BAD_USAGE;
+		}
+	}
+	return OPTIONS_OKAY;
+}
+
+int placement_parse_node(const char* node) {
+	char* end;
+	long n;
+
+	if (strcmp(node, "nic") == 0) {
+		placement.node = PLACEMENT_NIC;
+		return OPTIONS_OKAY;
+	}
+	if (strcmp(node, "remote") == 0) {
+		placement.node = PLACEMENT_REMOTE;
+		return OPTIONS_OKAY;
+	}
+	n = strtol(node, &end, 10);
+	if (end == node || *end != '\0' || n < 0 || n >= PLACEMENT_MAX_NODES) {
+		return OPTIONS_BAD_USAGE;
+	}
+	placement.node = (int) n;
+	return OPTIONS_OKAY;
+}
+
+// 2M or 1G hugetlbfs pages, or thp for transparent huge pages
+int placement_parse_pages(const char* pages) {
+	if (strcmp(pages, "2M") == 0) {
+		placement.pages = PAGES_2M;
+	}
+	else if (strcmp(pages, "1G") == 0) {
+		placement.pages = PAGES_1G;
+	}
+	else if (strcmp(pages, "thp") == 0) {
+		placement.pages = PAGES_THP;
+	}
+	else {
+		return OPTIONS_BAD_USAGE;
+	}
+	return OPTIONS_OKAY;
+}
+
+static int read_int(const char* path, int* value) {
+	FILE* f = fopen(path, "r");
+	int ret;
+
+	if (f == NULL) {
+		return 0;
+	}
+	ret = fscanf(f, "%d", value) == 1;
+	fclose(f);
+	return ret;
+}
+
+// the node of the first InfiniBand device that reports one
+static int nic_node(void) {
+	char path[4096];
+	struct dirent* entry;
+	DIR* dir;
+	int node = PLACEMENT_ANY;
+
+	dir = opendir("/sys/class/infiniband");
+	if (dir == NULL) {
+		return PLACEMENT_ANY;
+	}
+	while (node < 0 && (entry = readdir(dir)) != NULL) {
+		if (entry->d_name[0] == '.') {
+			continue;
+		}
+		snprintf(path,
+		         sizeof(path),
+		         "/sys/class/infiniband/%s/device/numa_node",
+		         entry->d_name);
+		if (!read_int(path, &node)) {
+			node = PLACEMENT_ANY;
+		}
+	}
+	closedir(dir);
+	return node < 0 ? PLACEMENT_ANY : node;
+}
+
+// the next online node after node, PLACEMENT_ANY if there is no other one
+static int other_node(const int node) {
+	char online[4096];
+	cpu_set_t nodes;
+	FILE* f;
+	int i, n;
+
+	f = fopen("/sys/devices/system/node/online", "r");
+	if (f == NULL) {
+		return PLACEMENT_ANY;
+	}
+	if (fgets(online, sizeof(online), f) == NULL) {
+		online[0] = '\0';
+	}
+	fclose(f);
+	online[strcspn(online, "\n")] = '\0';
+	if (parse_ranges(online, online + strlen(online), &nodes) !=
+	    OPTIONS_OKAY) {
+		return PLACEMENT_ANY;
+	}
+	for (i = 1; i < CPU_SETSIZE; ++i) {
+		n = (node + i) % CPU_SETSIZE;
+		if (CPU_ISSET(n, &nodes)) {
+			return n;
+		}
+	}
+	return PLACEMENT_ANY;
+}
+
+/*
+ * Called once GASPI is initialized: pins the calling rank and resolves the
+ * node given with --numa-node.
+ */
+void placement_init(void) {
+	gaspi_rank_t rank;
+	cpu_set_t set;
+
+	if (options.cpu_list != NULL) {
+		GASPI_CHECK(gaspi_proc_rank(&rank));
+		cpu_group(options.cpu_list, rank, &set);
+		if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+			fprintf(stderr,
+			        "Cannot pin rank %u to the cpu list %s\n",
+			        rank,
+			        options.cpu_list);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (sched_getaffinity(0, sizeof(placement.cpus), &placement.cpus) != 0) {
+		CPU_ZERO(&placement.cpus);
+	}
+	placement.nic = nic_node();
+	placement_set_node(placement.node);
+}
+
+// pins the calling thread to the t-th core of the rank, round-robin
+void placement_pin_thread(const int t) {
+	const int cores = CPU_COUNT(&placement.cpus);
+	cpu_set_t set;
+	int cpu, n = 0;
+
+	if (cores == 0) {
+		return;
+	}
+	for (cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+		if (CPU_ISSET(cpu, &placement.cpus) && n++ == t % cores) {
+			break;
+		}
+	}
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+		fprintf(stderr, "Cannot pin thread %d to core %d\n", t, cpu);
+		exit(EXIT_FAILURE);
+	}
+}
+
+// lets the calling thread run on every core of the rank again
+void placement_unpin_thread(void) {
+	if (CPU_COUNT(&placement.cpus) == 0) {
+		return;
+	}
+	if (pthread_setaffinity_np(
+	        pthread_self(), sizeof(placement.cpus), &placement.cpus) != 0) {
+		fprintf(stderr, "Cannot unpin thread\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+// segments allocated after this call are placed on node
+void placement_set_node(const int node) {
+	placement.node = node;
+	if (node == PLACEMENT_NIC || node == PLACEMENT_REMOTE) {
+		if (placement.nic == PLACEMENT_ANY) {
+			fprintf(stderr, "No NUMA node of an InfiniBand device found\n");
+			exit(EXIT_FAILURE);
+		}
+		placement.node = placement.nic;
+	}
+	if (node == PLACEMENT_REMOTE) {
+		placement.node = other_node(placement.nic);
+		if (placement.node == PLACEMENT_ANY) {
+			fprintf(stderr, "No NUMA node other than the NIC's found\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+int placement_node(void) {
+	return placement.node;
+}
+
+int placement_nic_node(void) {
+	return placement.nic;
+}
+
+// 1 if the segments are on the NIC's node, -1 if that node is unknown
+int placement_nic_local(void) {
+	if (placement.nic == PLACEMENT_ANY) {
+		return -1;
+	}
+	return placement.node == placement.nic;
+}
+
+static size_t page_size(void) {
+	switch (placement.pages) {
+		case PAGES_2M:
+		case PAGES_THP:
+			return HUGE_2M;
+		case PAGES_1G:
+			return HUGE_1G;
+		default:
+			return sysconf(_SC_PAGESIZE);
+	}
+}
+
+static size_t page_align(const size_t size) {
+	const size_t page = page_size();
+	return size > 0 ? (size + page - 1) / page * page : page;
+}
+
+static void* map_anonymous(const size_t length, const int flags) {
+	return mmap(NULL,
+	            length,
+	            PROT_READ | PROT_WRITE,
+	            MAP_PRIVATE | MAP_ANONYMOUS | flags,
+	            -1,
+	            0);
+}
+
+/*
+ * Transparent huge pages need a 2 MiB aligned range, so the mapping is cut
+ * out of a larger one before the kernel is asked for huge pages.
+ */
+static void* map_transparent(const size_t length) {
+	char* ptr = map_anonymous(length + HUGE_2M, 0);
+	char* aligned;
+
+	if (ptr == MAP_FAILED) {
+		return MAP_FAILED;
+	}
+	aligned = (char*) (((unsigned long) ptr + HUGE_2M - 1) & ~(HUGE_2M - 1));
+	if (aligned > ptr) {
+		munmap(ptr, aligned - ptr);
+	}
+	munmap(aligned + length, ptr + HUGE_2M - aligned);
+	if (madvise(aligned, length, MADV_HUGEPAGE) != 0) {
+		fprintf(stderr,
+		        "Transparent huge pages are not available, check "
+		        "/sys/kernel/mm/transparent_hugepage/enabled\n");
+		exit(EXIT_FAILURE);
+	}
+	return aligned;
+}
+
+static void* map_pages(const size_t length) {
+	void* ptr;
+
+	switch (placement.pages) {
+		case PAGES_2M:
+			ptr = map_anonymous(length, MAP_HUGETLB | 21 << MAP_HUGE_SHIFT);
+			break;
+		case PAGES_1G:
+			ptr = map_anonymous(length, MAP_HUGETLB | 30 << MAP_HUGE_SHIFT);
+			break;
+		case PAGES_THP:
+			ptr = map_transparent(length);
+			break;
+		default:
+			ptr = map_anonymous(length, 0);
+	}
+	if (ptr == MAP_FAILED) {
+		fprintf(stderr, "Cannot map %zu bytes", length);
+		if (placement.pages == PAGES_2M || placement.pages == PAGES_1G) {
+			fprintf(stderr,
+			        " of %s huge pages, check /sys/kernel/mm/hugepages",
+			        placement.pages == PAGES_2M ? "2M" : "1G");
+		}
+		fprintf(stderr, "\n");
+		exit(EXIT_FAILURE);
+	}
+	return ptr;
+}
+
+/*
+ * Memory bound to the selected node and backed by the selected pages, already
+ * faulted in. NULL if neither a node nor huge pages are selected.
+ */
+void* placement_alloc(const size_t size) {
+	unsigned long mask[PLACEMENT_MAX_NODES / BITS_PER_LONG];
+	const size_t length = page_align(size);
+	void* ptr;
+
+	if (placement.node < 0 && placement.pages == PAGES_DEFAULT) {
+		return NULL;
+	}
+	ptr = map_pages(length);
+	if (placement.node >= 0) {
+		memset(mask, 0, sizeof(mask));
+		mask[placement.node / BITS_PER_LONG] |=
+		    1UL << placement.node % BITS_PER_LONG;
+		if (syscall(SYS_mbind,
+		            ptr,
+		            length,
+		            MPOL_BIND,
+		            mask,
+		            PLACEMENT_MAX_NODES,
+		            MPOL_MF_STRICT | MPOL_MF_MOVE) != 0) {
+			fprintf(
+			    stderr, "Cannot bind memory to NUMA node %d\n", placement.node);
+			exit(EXIT_FAILURE);
+		}
+	}
+	memset(ptr, 0, length);
+	return ptr;
+}
+
+void placement_free(void* ptr, const size_t size) {
+	munmap(ptr, page_align(size));
+}
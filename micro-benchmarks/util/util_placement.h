@@ -0,0 +1,39 @@
+#ifndef __UTIL_PLACEMENT_H__
+#define __UTIL_PLACEMENT_H__
+#include <GASPI.h>
+#include <stddef.h>
+
+/*
+ * Placement of the ranks and of their segment memory.
+ *
+ * --cpu-list pins every rank to a set of cores, the colon separated groups
+ * are assigned to the ranks round-robin, e.g. "0-3:16-19". Threads of a rank
+ * are pinned to single cores of its set with placement_pin_thread and
+ * handed the whole set again with placement_unpin_thread.
+ *
+ * --numa-node places the segments allocated by util_memory on one NUMA node:
+ * the memory is mapped, bound to the node with mbind, touched and only then
+ * handed to GASPI with gaspi_segment_use, so it is registered where it lives.
+ * "nic" is the node of the InfiniBand device, "remote" the next other node.
+ *
+ * --hugepages backs the same segments with 2M or 1G hugetlbfs pages or with
+ * transparent huge pages (thp), also handed over with gaspi_segment_use.
+ */
+#define PLACEMENT_ANY -1
+#define PLACEMENT_NIC -2
+#define PLACEMENT_REMOTE -3
+#define PLACEMENT_MAX_NODES 1024
+
+int placement_parse_cpus(const char* list);
+int placement_parse_node(const char* node);
+int placement_parse_pages(const char* pages);
+void placement_init(void);
+void placement_set_node(const int node);
+void placement_pin_thread(const int t);
+void placement_unpin_thread(void);
+int placement_node(void);
+int placement_nic_node(void);
+int placement_nic_local(void);
+void* placement_alloc(const size_t size);
+void placement_free(void* ptr, const size_t size);
+#endif
@@ -0,0 +1,133 @@
+#include "util_raw.h"
+#include "check.h"
+#include "util.h"
+
+static FILE* raw_file = NULL;
+static uint32_t raw_rank;
+static uint64_t raw_iteration[RAW_CHUNK_CAPACITY];
+static double raw_start[RAW_CHUNK_CAPACITY];
+static double raw_duration[RAW_CHUNK_CAPACITY];
+static size_t raw_count = 0;
+
+// chunks written before their message size was known
+static long* pending = NULL;
+static size_t num_pending = 0;
+
+// leading samples of the current message size dropped as warm-up
+static uint64_t raw_warmup = 0;
+
+static void raw_sink_open(void) {
+	struct raw_file_header_t header;
+	char path[4096];
+	gaspi_rank_t rank;
+
+	GASPI_CHECK(gaspi_proc_rank(&rank));
+	raw_rank = rank;
+	snprintf(path, sizeof(path), "%s.%u.gbsraw", options.raw_file, raw_rank);
+	raw_file = fopen(path, "wb");
+	if (raw_file == NULL) {
+		fprintf(stderr, "Cannot open raw sample file %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, RAW_MAGIC, sizeof(header.magic));
+	header.version = RAW_VERSION;
+	header.rank = raw_rank;
+	header.timer = options.gaspi_timer;
+	fwrite(&header, sizeof(header), 1, raw_file);
+}
+
+static void raw_sink_write_chunk(const uint64_t size, const uint32_t warmup) {
+	struct raw_chunk_header_t chunk;
+
+	if (raw_file == NULL) {
+		raw_sink_open();
+	}
+	memset(&chunk, 0, sizeof(chunk));
+	chunk.size = size;
+	chunk.count = raw_count;
+	chunk.rank = raw_rank;
+	chunk.warmup = warmup;
+	strncpy(chunk.name, options.name, RAW_NAME_LENGTH - 1);
+	fwrite(&chunk, sizeof(chunk), 1, raw_file);
+	fwrite(raw_iteration, sizeof(*raw_iteration), raw_count, raw_file);
+	fwrite(raw_start, sizeof(*raw_start), raw_count, raw_file);
+	fwrite(raw_duration, sizeof(*raw_duration), raw_count, raw_file);
+	raw_count = 0;
+}
+
+/*
+ * Records are buffered and written at the end of a message size, outside of
+ * the timed region. Only a full buffer forces a write inside the iteration
+ * loop, the size of such a chunk is patched in by raw_sink_flush.
+ */
+void raw_sink_add(const int i, const double start, const double duration) {
+	if (options.raw_file == NULL) {
+		return;
+	}
+	raw_iteration[raw_count] = i;
+	raw_start[raw_count] = start;
+	raw_duration[raw_count] = duration;
+	if (++raw_count == RAW_CHUNK_CAPACITY) {
+		if (raw_file == NULL) {
+			raw_sink_open();
+		}
+		pending = realloc(pending, (num_pending + 1) * sizeof(*pending));
+		pending[num_pending++] = ftell(raw_file);
+		raw_sink_write_chunk(0, 0);
+	}
+}
+
+// the samples stay in the file, their chunks count them as warm-up
+void raw_sink_discard(const int n) {
+	if (options.raw_file != NULL) {
+		raw_warmup += n;
+	}
+}
+
+static uint32_t take_warmup(const uint64_t count) {
+	const uint64_t warmup = raw_warmup < count ? raw_warmup : count;
+
+	raw_warmup -= warmup;
+	return warmup;
+}
+
+void raw_sink_flush(const size_t size) {
+	const size_t warmup_offset = offsetof(struct raw_chunk_header_t, warmup);
+	uint64_t chunk_size = size;
+	uint32_t warmup;
+	long end;
+	size_t i;
+
+	if (options.raw_file == NULL || (raw_count == 0 && num_pending == 0)) {
+		raw_warmup = 0;
+		return;
+	}
+	// pending chunks hold the oldest samples of the message size
+	if (num_pending > 0) {
+		end = ftell(raw_file);
+		for (i = 0; i < num_pending; ++i) {
+			warmup = take_warmup(RAW_CHUNK_CAPACITY);
+			fseek(raw_file, pending[i], SEEK_SET);
+			fwrite(&chunk_size, sizeof(chunk_size), 1, raw_file);
+			fseek(raw_file, pending[i] + warmup_offset, SEEK_SET);
+			fwrite(&warmup, sizeof(warmup), 1, raw_file);
+		}
+		fseek(raw_file, end, SEEK_SET);
+		num_pending = 0;
+	}
+	if (raw_count > 0) {
+		raw_sink_write_chunk(size, take_warmup(raw_count));
+	}
+	raw_warmup = 0;
+}
+
+void raw_sink_close(void) {
+	if (raw_file != NULL) {
+		raw_sink_flush(0);
+		fclose(raw_file);
+		raw_file = NULL;
+	}
+	free(pending);
+	pending = NULL;
+}
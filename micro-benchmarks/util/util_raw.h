@@ -0,0 +1,46 @@
+#ifndef __UTIL_RAW_H__
+#define __UTIL_RAW_H__
+#include <inttypes.h>
+#include <stddef.h>
+
+/*
+ * Binary raw sample file, one per rank (<prefix>.<rank>.gbsraw).
+ *
+ * The file starts with a raw_file_header_t followed by chunks. Every chunk is
+ * a raw_chunk_header_t followed by its columns, each holding count values:
+ *   uint64_t iteration[count]
+ *   double   start[count]     timer value at the start of the iteration, ns
+ *   double   duration[count]  unconverted iteration time, ns
+ * Message size (segment count for the strided benchmarks), rank and benchmark
+ * are constant within a chunk and stored in its header. All parts are multiples
+ * of 8 bytes so the file can be mapped and the columns used in place.
+ *
+ * With --adaptive the first warmup samples of a chunk were dropped as warm-up
+ * and are not part of the reported statistics.
+ */
+#define RAW_MAGIC "GBSRAW1"
+#define RAW_VERSION 1
+#define RAW_CHUNK_CAPACITY 65536
+#define RAW_NAME_LENGTH 40
+
+struct raw_file_header_t {
+	char magic[8];
+	uint32_t version;
+	uint32_t rank;
+	uint32_t timer;
+	uint32_t reserved;
+};
+
+struct raw_chunk_header_t {
+	uint64_t size;
+	uint64_t count;
+	uint32_t rank;
+	uint32_t warmup;
+	char name[RAW_NAME_LENGTH];
+};
+
+void raw_sink_add(const int i, const double start, const double duration);
+void raw_sink_discard(const int n);
+void raw_sink_flush(const size_t size);
+void raw_sink_close(void);
+#endif
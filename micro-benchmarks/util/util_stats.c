@@ -0,0 +1,113 @@
+#include "util_stats.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+void welford_reset(struct welford_t* w) {
+	w->n = 0;
+	w->mean = 0;
+	w->m2 = 0;
+}
+
+void welford_add(struct welford_t* w, const double x) {
+	double delta = x - w->mean;
+	w->n++;
+	w->mean += delta / w->n;
+	w->m2 += delta * (x - w->mean);
+}
+
+// population variance, matching compute_statistics
+double welford_variance(const struct welford_t* w) {
+	return w->n > 0 ? w->m2 / w->n : 0;
+}
+
+static int msb(uint64_t v) {
+	return 63 - __builtin_clzll(v);
+}
+
+static size_t histogram_index(const uint64_t v) {
+	int shift;
+
+	if (v < HISTOGRAM_SUB_BUCKETS) {
+		return v;
+	}
+	shift = msb(v) - (HISTOGRAM_SUB_BUCKET_BITS - 1);
+	return (size_t) (shift + 1) * HISTOGRAM_HALF_SUB_BUCKETS +
+	       ((v >> shift) - HISTOGRAM_HALF_SUB_BUCKETS);
+}
+
+// center of the value range covered by a bucket
+static double histogram_value(const size_t index) {
+	size_t shift;
+	uint64_t lower;
+
+	if (index < HISTOGRAM_SUB_BUCKETS) {
+		return (double) index;
+	}
+	shift = index / HISTOGRAM_HALF_SUB_BUCKETS - 1;
+	lower = (uint64_t) (index % HISTOGRAM_HALF_SUB_BUCKETS +
+	                    HISTOGRAM_HALF_SUB_BUCKETS)
+	        << shift;
+	return (double) lower + (double) ((uint64_t) 1 << shift) / 2.0;
+}
+
+void histogram_reset(struct histogram_t* h) {
+	memset(h, 0, sizeof(*h));
+}
+
+void histogram_add(struct histogram_t* h, const double value) {
+	uint64_t v;
+	size_t index;
+
+	v = value > 0 ? (uint64_t) (value + 0.5) : 0;
+	index = histogram_index(v);
+	if (index >= HISTOGRAM_BUCKETS) {
+		index = HISTOGRAM_BUCKETS - 1;
+	}
+	h->counts[index]++;
+	h->total++;
+}
+
+// nearest rank percentile, p in [0, 1], ranked like sorted_percentile
+double histogram_percentile(const struct histogram_t* h, const double p) {
+	uint64_t rank, seen = 0;
+	size_t i;
+
+	if (h->total == 0) {
+		return 0;
+	}
+	rank = (uint64_t) ceil(p * h->total);
+	if (rank < 1) {
+		rank = 1;
+	}
+	if (rank > h->total) {
+		rank = h->total;
+	}
+	for (i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+		seen += h->counts[i];
+		if (seen >= rank) {
+			return histogram_value(i);
+		}
+	}
+	return histogram_value(HISTOGRAM_BUCKETS - 1);
+}
+
+void stream_statistics_reset(struct stream_statistics_t* s) {
+	welford_reset(&s->time);
+	welford_reset(&s->inverse);
+	s->min = DBL_MAX;
+	s->max = 0;
+	histogram_reset(&s->histogram);
+}
+
+void stream_statistics_add(struct stream_statistics_t* s, const double t) {
+	welford_add(&s->time, t);
+	welford_add(&s->inverse, t > 0 ? 1.0 / t : 0);
+	if (t < s->min) {
+		s->min = t;
+	}
+	if (t > s->max) {
+		s->max = t;
+	}
+	histogram_add(&s->histogram, t);
+}
@@ -0,0 +1,53 @@
+#ifndef __UTIL_STATS_H__
+#define __UTIL_STATS_H__
+#include <inttypes.h>
+#include <stddef.h>
+
+/*
+ * Fixed memory histogram with logarithmic buckets that are linearly divided
+ * into sub-buckets (HDR histogram layout). Values are recorded in ns, every
+ * value is resolved with a relative error below 1 / HISTOGRAM_SUB_BUCKETS.
+ */
+#define HISTOGRAM_SUB_BUCKET_BITS 8
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_HALF_SUB_BUCKETS (HISTOGRAM_SUB_BUCKETS / 2)
+#define HISTOGRAM_MAX_BITS 44 // ~4.9 hours in ns
+#define HISTOGRAM_BUCKETS                                       \
+	((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 2) * \
+	 HISTOGRAM_HALF_SUB_BUCKETS)
+
+struct welford_t {
+	uint64_t n;
+	double mean;
+	double m2;
+};
+
+struct histogram_t {
+	uint64_t total;
+	uint64_t counts[HISTOGRAM_BUCKETS];
+};
+
+/*
+ * Streaming accumulator of iteration times. The moments are kept for the
+ * times and for their reciprocals so that inverse metrics (bandwidth, rate)
+ * get exact means and variances without storing the samples.
+ */
+struct stream_statistics_t {
+	struct welford_t time;
+	struct welford_t inverse;
+	double min;
+	double max;
+	struct histogram_t histogram;
+};
+
+void welford_reset(struct welford_t* w);
+void welford_add(struct welford_t* w, const double x);
+double welford_variance(const struct welford_t* w);
+
+void histogram_reset(struct histogram_t* h);
+void histogram_add(struct histogram_t* h, const double value);
+double histogram_percentile(const struct histogram_t* h, const double p);
+
+void stream_statistics_reset(struct stream_statistics_t* s);
+void stream_statistics_add(struct stream_statistics_t* s, const double t);
+#endif
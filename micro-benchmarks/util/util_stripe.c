@@ -0,0 +1,246 @@
+#include "util_stripe.h"
+#include "check.h"
+#include "util.h"
+
+struct stripe_t {
+	int* queues; // queue counts given with --stripe-queues
+	int num_queues;
+	int* chunks; // chunks per message given with --stripe-chunks
+	int num_chunks;
+
+	// selected configuration
+	int queue_count;
+	int chunk_count;
+	int next; // queue of the next chunk
+};
+
+static struct stripe_t stripe = {NULL, 0, NULL, 0, 1, 1, 0};
+
+// parse a comma separated list of positive numbers
+static int parse_list(const char* list, int** values) {
+	const char* c = list;
+	char* end;
+	int n = 0;
+
+	free(*values);
+	*values = malloc((strlen(list) / 2 + 1) * sizeof(**values));
+	while (*c != '\0') {
+		(*values)[n] = (int) strtol(c, &end, 10);
+		if (end == c || (*end != ',' && *end != '\0') || (*values)[n] <= 0) {
+			free(*values);
+			*values = NULL;
+			return 0;
+		}
+		++n;
+		c = *end == ',' ? end + 1 : end;
+	}
+	return n;
+}
+
+int stripe_parse_queues(const char* list) {
+	stripe.num_queues = parse_list(list, &stripe.queues);
+	return stripe.num_queues > 0 ? OPTIONS_OKAY : OPTIONS_BAD_USAGE;
+}
+
+int stripe_parse_chunks(const char* list) {
+	stripe.num_chunks = parse_list(list, &stripe.chunks);
+	return stripe.num_chunks > 0 ? OPTIONS_OKAY : OPTIONS_BAD_USAGE;
+}
+
+// called once all options are parsed
+int stripe_check(void) {
+	if ((stripe_active() || options.queue_depth > 0) &&
+	    (options.type != ONESIDED || options.subtype != BW)) {
+		return OPTIONS_BAD_USAGE;
+	}
+	stripe_select(0);
+	return OPTIONS_OKAY;
+}
+
+// called once GASPI is initialized, the queues must exist already
+void stripe_init(void) {
+	gaspi_number_t queue_num, queue_size_max;
+	int i;
+
+	GASPI_CHECK(gaspi_queue_size_max(&queue_size_max));
+	// --queue-depth and --stripe-queues only take positive numbers
+	if ((gaspi_number_t) options.queue_depth > queue_size_max) {
+		fprintf(stderr,
+		        "--queue-depth %d exceeds the queue size of %u requests\n",
+		        options.queue_depth,
+		        queue_size_max);
+		exit(EXIT_FAILURE);
+	}
+	GASPI_CHECK(gaspi_queue_num(&queue_num));
+	for (i = 0; i < stripe.num_queues; ++i) {
+		if ((gaspi_number_t) stripe.queues[i] > queue_num) {
+			fprintf(stderr,
+			        "--stripe-queues %d exceeds the %u queues of GASPI\n",
+			        stripe.queues[i],
+			        queue_num);
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+int stripe_active(void) {
+	return stripe.num_queues > 0 || stripe.num_chunks > 0;
+}
+
+// number of queue and chunk count combinations
+int stripe_configs(void) {
+	return (stripe.num_queues > 0 ? stripe.num_queues : 1) *
+	       (stripe.num_chunks > 0 ? stripe.num_chunks : 1);
+}
+
+void stripe_select(const int config) {
+	const int chunk_configs = stripe.num_chunks > 0 ? stripe.num_chunks : 1;
+
+	stripe.queue_count =
+	    stripe.num_queues > 0 ? stripe.queues[config / chunk_configs] : 1;
+	stripe.chunk_count =
+	    stripe.num_chunks > 0 ? stripe.chunks[config % chunk_configs] : 1;
+	stripe.next = 0;
+}
+
+int stripe_queues(void) {
+	return stripe.queue_count;
+}
+
+int stripe_chunks(void) {
+	return stripe.chunk_count;
+}
+
+// completes requests until fewer than --queue-depth are left in the queue
+static void throttle(const gaspi_queue_id_t q_id) {
+	gaspi_number_t queued;
+	gaspi_return_t ret;
+
+	GASPI_CHECK(gaspi_queue_size(q_id, &queued));
+	while (queued >= (gaspi_number_t) options.queue_depth) {
+		ret = gaspi_wait(q_id, GASPI_TEST);
+		if (ret != GASPI_TIMEOUT) {
+			GASPI_CHECK(ret);
+		}
+		GASPI_CHECK(gaspi_queue_size(q_id, &queued));
+	}
+}
+
+// posts one chunk, waits for the queue and retries if the queue is full
+static void post(const int read,
+                 const gaspi_segment_id_t segment_id_local,
+                 const gaspi_offset_t offset_local,
+                 const gaspi_rank_t rank,
+                 const gaspi_segment_id_t segment_id_remote,
+                 const gaspi_offset_t offset_remote,
+                 const size_t size) {
+	const gaspi_queue_id_t q_id = stripe.next;
+	gaspi_return_t ret;
+
+	stripe.next = stripe.next + 1 < stripe.queue_count ? stripe.next + 1 : 0;
+	if (options.queue_depth > 0) {
+		throttle(q_id);
+	}
+	while (1) {
+		if (read) {
+			ret = gaspi_read(segment_id_local,
+			                 offset_local,
+			                 rank,
+			                 segment_id_remote,
+			                 offset_remote,
+			                 size,
+			                 q_id,
+			                 GASPI_BLOCK);
+		}
+		else {
+			ret = gaspi_write(segment_id_local,
+			                  offset_local,
+			                  rank,
+			                  segment_id_remote,
+			                  offset_remote,
+			                  size,
+			                  q_id,
+			                  GASPI_BLOCK);
+		}
+		if (ret != GASPI_QUEUE_FULL) {
+			break;
+		}
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	}
+	GASPI_CHECK(ret);
+}
+
+/*
+ * Splits size into chunk_count chunks of equal size, the last one takes the
+ * remainder. Messages smaller than the chunk count are split into bytes.
+ */
+static void post_chunks(const int read,
+                        const gaspi_segment_id_t segment_id_local,
+                        const gaspi_offset_t offset_local,
+                        const gaspi_rank_t rank,
+                        const gaspi_segment_id_t segment_id_remote,
+                        const gaspi_offset_t offset_remote,
+                        const size_t size) {
+	const size_t chunks =
+	    size < (size_t) stripe.chunk_count ? size : (size_t) stripe.chunk_count;
+	const size_t chunk = chunks > 0 ? size / chunks : 0;
+	size_t c, offset;
+
+	for (c = 0; c < chunks; ++c) {
+		offset = c * chunk;
+		post(read,
+		     segment_id_local,
+		     offset_local + offset,
+		     rank,
+		     segment_id_remote,
+		     offset_remote + offset,
+		     c + 1 < chunks ? chunk : size - offset);
+	}
+}
+
+void stripe_write(const gaspi_segment_id_t segment_id_local,
+                  const gaspi_offset_t offset_local,
+                  const gaspi_rank_t rank,
+                  const gaspi_segment_id_t segment_id_remote,
+                  const gaspi_offset_t offset_remote,
+                  const size_t size) {
+	post_chunks(0,
+	            segment_id_local,
+	            offset_local,
+	            rank,
+	            segment_id_remote,
+	            offset_remote,
+	            size);
+}
+
+void stripe_read(const gaspi_segment_id_t segment_id_local,
+                 const gaspi_offset_t offset_local,
+                 const gaspi_rank_t rank,
+                 const gaspi_segment_id_t segment_id_remote,
+                 const gaspi_offset_t offset_remote,
+                 const size_t size) {
+	post_chunks(1,
+	            segment_id_local,
+	            offset_local,
+	            rank,
+	            segment_id_remote,
+	            offset_remote,
+	            size);
+}
+
+// waits for every queue of the selected configuration
+void stripe_wait(void) {
+	int q;
+
+	for (q = 0; q < stripe.queue_count; ++q) {
+		GASPI_CHECK(gaspi_wait(q, GASPI_BLOCK));
+	}
+	stripe.next = 0;
+}
+
+// end of an iteration, the queues stay filled under flow control
+void stripe_complete(void) {
+	if (options.queue_depth == 0) {
+		stripe_wait();
+	}
+}
@@ -0,0 +1,43 @@
+#ifndef __UTIL_STRIPE_H__
+#define __UTIL_STRIPE_H__
+#include <GASPI.h>
+#include <stddef.h>
+
+/*
+ * Striping of the bandwidth benchmarks: every message is split into chunks
+ * that are posted round-robin to the first queues, e.g. to use several rails
+ * of a node. --stripe-queues and --stripe-chunks take lists, the message size
+ * sweep is repeated for every combination (see util_sweep):
+ *   stripe_write(segment_id, offset, 1, segment_id, offset, size);
+ *   stripe_wait();
+ * Without the options a message is a single transfer on queue 0.
+ *
+ * With --queue-depth N a chunk is only posted once its queue holds fewer than
+ * N requests, completed ones are reaped with gaspi_wait(GASPI_TEST). The
+ * iterations then end with stripe_complete(), which leaves the queues filled,
+ * and a final stripe_wait() drains them after the measurement.
+ */
+int stripe_parse_queues(const char* list);
+int stripe_parse_chunks(const char* list);
+int stripe_check(void);
+void stripe_init(void);
+int stripe_active(void);
+int stripe_configs(void);
+void stripe_select(const int config);
+int stripe_queues(void);
+int stripe_chunks(void);
+void stripe_write(const gaspi_segment_id_t segment_id_local,
+                  const gaspi_offset_t offset_local,
+                  const gaspi_rank_t rank,
+                  const gaspi_segment_id_t segment_id_remote,
+                  const gaspi_offset_t offset_remote,
+                  const size_t size);
+void stripe_read(const gaspi_segment_id_t segment_id_local,
+                 const gaspi_offset_t offset_local,
+                 const gaspi_rank_t rank,
+                 const gaspi_segment_id_t segment_id_remote,
+                 const gaspi_offset_t offset_remote,
+                 const size_t size);
+void stripe_wait(void);
+void stripe_complete(void);
+#endif
@@ -0,0 +1,397 @@
+#include "util_sweep.h"
+#include <math.h>
+#include "check.h"
+#include "util.h"
+#include "util_delivery.h"
+#include "util_offsets.h"
+#include "util_stripe.h"
+
+struct sweep_t {
+	enum sweep_mode mode;
+	size_t step;
+	int per_octave;
+	double tolerance;
+	size_t* list;
+	int list_length;
+
+	int* windows;
+	int num_windows;
+	int config; // window size, stripe, cache and delivery of the pass
+	int default_window;
+
+	// points in measurement order, values are only known on rank 0
+	size_t* points;
+	double* values;
+	int num_points;
+	int capacity;
+	int current;
+	int refinements;
+};
+
+static struct sweep_t sweep = {SWEEP_POW2};
+
+// parse a comma separated list of positive numbers
+static int parse_list(const char* list, size_t** values) {
+	const char* c = list;
+	char* end;
+	int n = 0;
+
+	*values = malloc((strlen(list) / 2 + 1) * sizeof(**values));
+	while (*c != '\0') {
+		(*values)[n] = strtoull(c, &end, 10);
+		if (end == c || (*end != ',' && *end != '\0') || (*values)[n] == 0) {
+			free(*values);
+			*values = NULL;
+			return 0;
+		}
+		++n;
+		c = *end == ',' ? end + 1 : end;
+	}
+	return n;
+}
+
+/*
+ * pow2          powers of two between the minimum and maximum size (default)
+ * linear:STEP   minimum size plus multiples of STEP
+ * log:N         N logarithmically spaced sizes per octave
+ * list:A,B,...  explicit sizes, overrides minimum and maximum size
+ * adaptive[:T]  powers of two, refined where the median deviates by more
+ *               than the relative tolerance T from its neighbors' trend
+ */
+int sweep_parse(const char* spec) {
+	const char* arg = strchr(spec, ':');
+
+	arg = arg == NULL ? "" : arg + 1;
+	if (strcmp(spec, "pow2") == 0) {
+		sweep.mode = SWEEP_POW2;
+	}
+	else if (strncmp(spec, "linear:", 7) == 0) {
+		sweep.mode = SWEEP_LINEAR;
+		sweep.step = strtoull(arg, NULL, 10);
+		if (sweep.step == 0) {
+			return OPTIONS_BAD_USAGE;
+		}
+	}
+	else if (strncmp(spec, "log:", 4) == 0) {
+		sweep.mode = SWEEP_LOG;
+		sweep.per_octave = atoi(arg);
+		if (sweep.per_octave <= 0) {
+			return OPTIONS_BAD_USAGE;
+		}
+	}
+	else if (strncmp(spec, "list:", 5) == 0) {
+		sweep.mode = SWEEP_LIST;
+		free(sweep.list);
+		sweep.list_length = parse_list(arg, &sweep.list);
+		if (sweep.list_length == 0) {
+			return OPTIONS_BAD_USAGE;
+		}
+	}
+	else if (strcmp(spec, "adaptive") == 0 ||
+	         strncmp(spec, "adaptive:", 9) == 0) {
+		sweep.mode = SWEEP_ADAPTIVE;
+		sweep.tolerance =
+		    *arg == '\0' ? SWEEP_DEFAULT_TOLERANCE : strtod(arg, NULL);
+		if (sweep.tolerance <= 0) {
+			return OPTIONS_BAD_USAGE;
+		}
+	}
+	else {
+		return OPTIONS_BAD_USAGE;
+	}
+	return OPTIONS_OKAY;
+}
+
+int sweep_parse_windows(const char* list) {
+	size_t* windows;
+	int i;
+
+	free(sweep.windows);
+	sweep.num_windows = parse_list(list, &windows);
+	if (sweep.num_windows == 0) {
+		return OPTIONS_BAD_USAGE;
+	}
+	sweep.windows = malloc(sweep.num_windows * sizeof(*sweep.windows));
+	for (i = 0; i < sweep.num_windows; ++i) {
+		sweep.windows[i] = (int) windows[i];
+	}
+	free(windows);
+	return OPTIONS_OKAY;
+}
+
+// called once all options are parsed
+int sweep_check(void) {
+	int i;
+
+	if (sweep.num_windows > 0 &&
+	    ((options.type != ONESIDED && options.type != PASSIVE &&
+	      options.type != DRIVER) ||
+	     options.subtype == OVERLAP)) {
+		return OPTIONS_BAD_USAGE;
+	}
+	if (sweep.mode == SWEEP_LIST) {
+		// keep single buffer allocations large enough for every size
+		options.min_message_size = sweep.list[0];
+		options.max_message_size = sweep.list[0];
+		for (i = 1; i < sweep.list_length; ++i) {
+			if (sweep.list[i] < options.min_message_size) {
+				options.min_message_size = sweep.list[i];
+			}
+			if (sweep.list[i] > options.max_message_size) {
+				options.max_message_size = sweep.list[i];
+			}
+		}
+	}
+	return OPTIONS_OKAY;
+}
+
+// the window size is part of the result only for message size sweeps
+int sweep_windows(void) {
+	return sweep.num_windows > 0 &&
+	       (options.type == ONESIDED || options.type == PASSIVE);
+}
+
+// the largest window size of the sweep, for sizing the segments up front
+int sweep_max_window(void) {
+	int max = options.window_size;
+	int i;
+
+	for (i = 0; i < sweep.num_windows; ++i) {
+		if (sweep.windows[i] > max) {
+			max = sweep.windows[i];
+		}
+	}
+	return max;
+}
+
+static void add_point(const size_t size) {
+	if (sweep.num_points == sweep.capacity) {
+		sweep.capacity = sweep.capacity == 0 ? 64 : 2 * sweep.capacity;
+		sweep.points =
+		    realloc(sweep.points, sweep.capacity * sizeof(*sweep.points));
+		sweep.values =
+		    realloc(sweep.values, sweep.capacity * sizeof(*sweep.values));
+	}
+	sweep.points[sweep.num_points] = size;
+	sweep.values[sweep.num_points] = NAN;
+	++sweep.num_points;
+}
+
+static void build_points(void) {
+	const size_t min = options.min_message_size;
+	const size_t max = options.max_message_size;
+	size_t size, last = 0;
+	int i;
+
+	sweep.num_points = 0;
+	sweep.current = 0;
+	sweep.refinements = 0;
+	switch (sweep.mode) {
+		case SWEEP_POW2:
+		case SWEEP_ADAPTIVE:
+			for (size = min; size > 0 && size <= max; size *= 2) {
+				add_point(size);
+			}
+			break;
+		case SWEEP_LINEAR:
+			for (size = min; size > 0 && size <= max; size += sweep.step) {
+				add_point(size);
+			}
+			break;
+		case SWEEP_LOG:
+			for (i = 0;; ++i) {
+				size = (size_t) round(min *
+				                      pow(2.0, (double) i / sweep.per_octave));
+				if (size == 0 || size > max) {
+					break;
+				}
+				if (size != last) {
+					add_point(size);
+					last = size;
+				}
+			}
+			break;
+		case SWEEP_LIST:
+			// the benchmark may have lowered the maximum after parsing
+			for (i = 0; i < sweep.list_length; ++i) {
+				if (sweep.list[i] <= max) {
+					add_point(sweep.list[i]);
+				}
+			}
+			break;
+	}
+}
+
+static int is_point(const size_t size) {
+	int i;
+
+	for (i = 0; i < sweep.num_points; ++i) {
+		if (sweep.points[i] == size) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int point_cmp(const void* a, const void* b) {
+	const size_t x = sweep.points[*((const int*) (a))];
+	const size_t y = sweep.points[*((const int*) (b))];
+	return (x > y) - (x < y);
+}
+
+// log-log slope between two measured points
+static double slope(const int a, const int b) {
+	return log(sweep.values[b] / sweep.values[a]) /
+	       log((double) sweep.points[b] / sweep.points[a]);
+}
+
+/*
+ * Pick the interval between neighboring sizes whose change of the median is
+ * explained worst by the trend of the adjacent intervals, e.g. a jump at a
+ * protocol switch, and return a size inside of it. Returns SWEEP_END when no
+ * interval deviates by more than the tolerance.
+ */
+static size_t refine(void) {
+	int* order;
+	int n = 0, i, k;
+	double actual, expected, excess, best = log(1.0 + sweep.tolerance);
+	size_t lower, upper, mid, size = SWEEP_END;
+
+	if (sweep.refinements >= SWEEP_MAX_REFINEMENTS) {
+		return SWEEP_END;
+	}
+	order = malloc(sweep.num_points * sizeof(*order));
+	for (i = 0; i < sweep.num_points; ++i) {
+		if (sweep.values[i] > 0) {
+			order[n++] = i;
+		}
+	}
+	qsort(order, n, sizeof(*order), point_cmp);
+
+	for (k = 0; k + 1 < n; ++k) {
+		lower = sweep.points[order[k]];
+		upper = sweep.points[order[k + 1]];
+		if (upper - lower < 2) {
+			continue;
+		}
+		actual = log(sweep.values[order[k + 1]] / sweep.values[order[k]]);
+		excess = INFINITY;
+		if (k > 0) {
+			expected = slope(order[k - 1], order[k]) *
+			           log((double) upper / lower);
+			excess = fmin(excess, fabs(actual - expected));
+		}
+		if (k + 2 < n) {
+			expected = slope(order[k + 1], order[k + 2]) *
+			           log((double) upper / lower);
+			excess = fmin(excess, fabs(actual - expected));
+		}
+		if (excess == INFINITY || excess <= best) {
+			continue;
+		}
+		mid = (size_t) round(sqrt((double) lower * upper));
+		if (mid <= lower || mid >= upper) {
+			mid = lower + (upper - lower) / 2;
+		}
+		if (!is_point(mid)) {
+			best = excess;
+			size = mid;
+		}
+	}
+	free(order);
+	return size;
+}
+
+// rank 0 holds the results, all other ranks follow its decision
+static size_t next_adaptive(void) {
+	gaspi_rank_t rank;
+	unsigned long next = SWEEP_END, size;
+
+	GASPI_CHECK(gaspi_proc_rank(&rank));
+	if (rank == 0) {
+		next = sweep.current + 1 < sweep.num_points
+		           ? sweep.points[sweep.current + 1]
+		           : refine();
+	}
+	GASPI_CHECK(gaspi_allreduce(&next,
+	                            &size,
+	                            1,
+	                            GASPI_OP_MAX,
+	                            GASPI_TYPE_ULONG,
+	                            GASPI_GROUP_ALL,
+	                            GASPI_BLOCK));
+	if (size == SWEEP_END) {
+		return SWEEP_END;
+	}
+	if (sweep.current + 1 == sweep.num_points) {
+		add_point(size);
+		++sweep.refinements;
+	}
+	return sweep.points[++sweep.current];
+}
+
+// passes of the sweep, one per window size, stripe configuration and
+// delivery mode, the innermost passes follow each other
+static int num_configs(void) {
+	return (sweep.num_windows > 0 ? sweep.num_windows : 1) * stripe_configs() *
+	       delivery_configs();
+}
+
+static size_t first_point(void) {
+	int config = sweep.config;
+
+	offsets_select(OFFSETS_HOT);
+	delivery_select(config % delivery_configs());
+	config /= delivery_configs();
+	stripe_select(config % stripe_configs());
+	config /= stripe_configs();
+	if (sweep.num_windows > 0) {
+		options.window_size = sweep.windows[config];
+	}
+	build_points();
+	return sweep.num_points > 0 ? sweep.points[0] : SWEEP_END;
+}
+
+size_t sweep_first(void) {
+	sweep.default_window = options.window_size;
+	sweep.config = 0;
+	return first_point();
+}
+
+size_t sweep_next(void) {
+	size_t size = SWEEP_END;
+
+	// the cold pass of a size follows its hot pass
+	if (offsets_configs() > 1 && !offsets_cold()) {
+		offsets_select(OFFSETS_COLD);
+		return sweep.points[sweep.current];
+	}
+	offsets_select(OFFSETS_HOT);
+	if (sweep.mode == SWEEP_ADAPTIVE) {
+		size = next_adaptive();
+	}
+	else if (sweep.current + 1 < sweep.num_points) {
+		size = sweep.points[++sweep.current];
+	}
+	if (size != SWEEP_END) {
+		return size;
+	}
+	while (++sweep.config < num_configs()) {
+		size = first_point();
+		if (size != SWEEP_END) {
+			return size;
+		}
+	}
+	options.window_size = sweep.default_window;
+	stripe_select(0);
+	offsets_select(OFFSETS_NONE);
+	delivery_select(0);
+	return SWEEP_END;
+}
+
+// median of the current point, drives the adaptive refinement
+void sweep_record(const double value) {
+	if (sweep.current < sweep.num_points) {
+		sweep.values[sweep.current] = value;
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef __UTIL_SWEEP_H__
+#define __UTIL_SWEEP_H__
+#include <stddef.h>
+
+/*
+ * Message size sweep shared by all sized benchmarks:
+ *   for (size = sweep_first(); size != SWEEP_END; size = sweep_next())
+ * The sweep also sets options.window_size when a list of window sizes is
+ * given, every size is then measured for every window size, and selects
+ * every stripe configuration of util_stripe and the delivery modes of
+ * util_delivery in turn. With --cold-cache every size is returned twice, for
+ * the hot and then for the cold pass of util_offsets.
+ */
+#define SWEEP_END 0
+#define SWEEP_MAX_REFINEMENTS 32
+#define SWEEP_DEFAULT_TOLERANCE 0.1
+
+enum sweep_mode {
+	SWEEP_POW2 = 0,
+	SWEEP_LINEAR,
+	SWEEP_LOG,
+	SWEEP_LIST,
+	SWEEP_ADAPTIVE
+};
+
+int sweep_parse(const char* spec);
+int sweep_parse_windows(const char* list);
+int sweep_check(void);
+int sweep_windows(void);
+int sweep_max_window(void);
+size_t sweep_first(void);
+size_t sweep_next(void);
+void sweep_record(const double value);
+#endif
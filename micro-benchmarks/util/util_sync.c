@@ -0,0 +1,54 @@
+#include "util_sync.h"
+#include "check.h"
+#include "stopwatch.h"
+
+struct pair_sync_t {
+	int enabled;
+	int epoch; // synchronizations so far, selects the notification
+	double cost; // mean ns of the last calibration
+};
+
+static struct pair_sync_t sync_state;
+
+void pair_sync_enable(const int enabled) {
+	sync_state.enabled = enabled;
+	sync_state.cost = 0;
+}
+
+int pair_sync_enabled(void) {
+	return sync_state.enabled;
+}
+
+void pair_sync(const gaspi_segment_id_t segment_id,
+               const gaspi_rank_t partner,
+               const gaspi_queue_id_t q_id) {
+	const gaspi_notification_id_t id = SYNC_FIRST_ID + sync_state.epoch % 2;
+	gaspi_notification_id_t first;
+	gaspi_notification_t value;
+
+	GASPI_CHECK(gaspi_notify(segment_id, partner, id, 1, q_id, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_notify_waitsome(segment_id, id, 1, &first, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_notify_reset(segment_id, first, &value));
+	GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	++sync_state.epoch;
+}
+
+void pair_sync_calibrate(const gaspi_segment_id_t segment_id,
+                         const gaspi_rank_t partner,
+                         const gaspi_queue_id_t q_id) {
+	double time;
+	int i;
+
+	// the first one only waits for the partner to arrive
+	pair_sync(segment_id, partner, q_id);
+	time = stopwatch_start();
+	for (i = 0; i < SYNC_ROUNDS; ++i) {
+		pair_sync(segment_id, partner, q_id);
+	}
+	sync_state.cost = stopwatch_stop(time) / SYNC_ROUNDS;
+}
+
+// mean ns of a synchronization in the last calibration
+double pair_sync_cost(void) {
+	return sync_state.cost;
+}
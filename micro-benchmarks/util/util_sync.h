@@ -0,0 +1,29 @@
+#ifndef __UTIL_SYNC_H__
+#define __UTIL_SYNC_H__
+#include <GASPI.h>
+
+/*
+ * Synchronization of the two ranks of a benchmark inside its timed loop.
+ * pair_sync sends a gaspi_notify to the partner and waits for the partner's,
+ * one message each way instead of the rounds of a gaspi_barrier. It takes
+ * the notifications SYNC_FIRST_ID and SYNC_FIRST_ID + 1 of the segment, used
+ * in turn so that a partner running ahead cannot overwrite a notification
+ * not yet reset. Call it once the writes to the partner completed locally.
+ *
+ * pair_sync_calibrate times SYNC_ROUNDS synchronizations alone before a
+ * message size. Once a benchmark calls pair_sync_enable, every result row
+ * carries their mean as pair_sync_us so it can be subtracted from the row.
+ */
+#define SYNC_FIRST_ID 0
+#define SYNC_ROUNDS 100
+
+void pair_sync_enable(const int enabled);
+int pair_sync_enabled(void);
+void pair_sync(const gaspi_segment_id_t segment_id,
+               const gaspi_rank_t partner,
+               const gaspi_queue_id_t q_id);
+void pair_sync_calibrate(const gaspi_segment_id_t segment_id,
+                         const gaspi_rank_t partner,
+                         const gaspi_queue_id_t q_id);
+double pair_sync_cost(void);
+#endif
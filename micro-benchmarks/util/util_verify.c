@@ -0,0 +1,296 @@
+#include "util_verify.h"
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define VERIFY_HAVE_SIMD
+#endif
+#include "check.h"
+#include "util.h"
+
+typedef int (*check_words_t)(const uint64_t* p,
+                             const size_t first,
+                             const size_t n,
+                             const uint64_t seed);
+
+static check_words_t check_words = NULL;
+static int every_enabled = 0;
+
+void verify_every_enable(void) {
+	every_enabled = 1;
+}
+
+int verify_every_enabled(void) {
+	return every_enabled;
+}
+
+int verify_iteration(const int i) {
+	return options.verify &&
+	       (i == 0 ||
+	        (options.verify_every > 0 && i % options.verify_every == 0));
+}
+
+// splitmix64 finalizer
+static uint64_t mix(uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+uint64_t verify_seed(const gaspi_rank_t rank,
+                     const size_t size,
+                     const int iteration) {
+	return mix(mix(mix(rank) ^ size) ^ (uint64_t) iteration);
+}
+
+static uint64_t word(const uint64_t seed, const size_t w) {
+	return seed + w * VERIFY_STRIDE;
+}
+
+// byte x of the pattern, in the byte order the words are stored in
+static unsigned char pattern_byte(const uint64_t seed, const size_t x) {
+	const uint64_t w = word(seed, x / 8);
+	unsigned char bytes[8];
+
+	memcpy(bytes, &w, sizeof(bytes));
+	return bytes[x % 8];
+}
+
+static int check_words_scalar(const uint64_t* p,
+                              const size_t first,
+                              const size_t n,
+                              const uint64_t seed) {
+	uint64_t diff = 0;
+	size_t w;
+
+	for (w = 0; w < n; ++w) {
+		diff |= p[w] ^ word(seed, first + w);
+	}
+	return diff == 0;
+}
+
+#ifdef VERIFY_HAVE_SIMD
+__attribute__((target("avx2"))) static int check_words_avx2(
+    const uint64_t* p,
+    const size_t first,
+    const size_t n,
+    const uint64_t seed) {
+	const __m256i step = _mm256_set1_epi64x((long long) (4 * VERIFY_STRIDE));
+	__m256i expected = _mm256_set_epi64x((long long) word(seed, first + 3),
+	                                     (long long) word(seed, first + 2),
+	                                     (long long) word(seed, first + 1),
+	                                     (long long) word(seed, first));
+	__m256i diff = _mm256_setzero_si256();
+	size_t w;
+
+	for (w = 0; w + 4 <= n; w += 4) {
+		diff = _mm256_or_si256(
+		    diff,
+		    _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (p + w)),
+		                     expected));
+		expected = _mm256_add_epi64(expected, step);
+	}
+	return _mm256_testz_si256(diff, diff) &&
+	       check_words_scalar(p + w, first + w, n - w, seed);
+}
+
+__attribute__((target("avx512f"))) static int check_words_avx512(
+    const uint64_t* p,
+    const size_t first,
+    const size_t n,
+    const uint64_t seed) {
+	const __m512i step = _mm512_set1_epi64((long long) (8 * VERIFY_STRIDE));
+	__m512i expected = _mm512_set_epi64((long long) word(seed, first + 7),
+	                                    (long long) word(seed, first + 6),
+	                                    (long long) word(seed, first + 5),
+	                                    (long long) word(seed, first + 4),
+	                                    (long long) word(seed, first + 3),
+	                                    (long long) word(seed, first + 2),
+	                                    (long long) word(seed, first + 1),
+	                                    (long long) word(seed, first));
+	__m512i diff = _mm512_setzero_si512();
+	size_t w;
+
+	for (w = 0; w + 8 <= n; w += 8) {
+		diff = _mm512_or_si512(
+		    diff, _mm512_xor_si512(_mm512_loadu_si512(p + w), expected));
+		expected = _mm512_add_epi64(expected, step);
+	}
+	return _mm512_test_epi64_mask(diff, diff) == 0 &&
+	       check_words_scalar(p + w, first + w, n - w, seed);
+}
+#endif
+
+static check_words_t select_check_words(void) {
+#ifdef VERIFY_HAVE_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) {
+		return check_words_avx512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return check_words_avx2;
+	}
+#endif
+	return check_words_scalar;
+}
+
+// the word aligned part [*begin, *end) of [offset, offset + size)
+static void split(const size_t offset,
+                  const size_t size,
+                  size_t* begin,
+                  size_t* end) {
+	*begin = (offset + 7) / 8 * 8;
+	*end = (offset + size) / 8 * 8;
+	if (*begin > *end) {
+		*begin = offset + size;
+		*end = offset + size;
+	}
+}
+
+void verify_fill(const gaspi_segment_id_t segment_id,
+                 const size_t offset,
+                 const size_t size,
+                 const uint64_t seed) {
+	unsigned char* base;
+	gaspi_pointer_t ptr;
+	size_t begin, end, x;
+
+	GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+	base = ptr;
+	split(offset, size, &begin, &end);
+	for (x = offset; x < begin; ++x) {
+		base[x] = pattern_byte(seed, x);
+	}
+	for (x = begin; x < end; x += 8) {
+		((uint64_t*) base)[x / 8] = word(seed, x / 8);
+	}
+	for (x = end; x < offset + size; ++x) {
+		base[x] = pattern_byte(seed, x);
+	}
+}
+
+void verify_clear(const gaspi_segment_id_t segment_id,
+                  const size_t offset,
+                  const size_t size) {
+	gaspi_pointer_t ptr;
+
+	GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+	memset((char*) ptr + offset, 0, size);
+}
+
+int verify_check(const gaspi_segment_id_t segment_id,
+                 const size_t offset,
+                 const size_t size,
+                 const uint64_t seed) {
+	const unsigned char* base;
+	gaspi_pointer_t ptr;
+	size_t begin, end, x;
+
+	if (check_words == NULL) {
+		check_words = select_check_words();
+	}
+	GASPI_CHECK(gaspi_segment_ptr(segment_id, &ptr));
+	base = ptr;
+	split(offset, size, &begin, &end);
+	for (x = offset; x < begin; ++x) {
+		if (base[x] != pattern_byte(seed, x)) {
+			return 0;
+		}
+	}
+	for (x = end; x < offset + size; ++x) {
+		if (base[x] != pattern_byte(seed, x)) {
+			return 0;
+		}
+	}
+	// segments are page aligned, so are the words
+	return check_words(
+	    (const uint64_t*) (base + begin), begin / 8, (end - begin) / 8, seed);
+}
+
+// the same range of the segment on rank, in transfers of at most the
+// maximum transfer size
+static void transfer(const int read,
+                     const gaspi_segment_id_t segment_id,
+                     const size_t offset,
+                     const size_t size,
+                     const gaspi_rank_t rank) {
+	const gaspi_queue_id_t q_id = 0;
+	gaspi_size_t max;
+	size_t done, chunk;
+
+	GASPI_CHECK(gaspi_transfer_size_max(&max));
+	for (done = 0; done < size; done += chunk) {
+		chunk = size - done < max ? size - done : max;
+		if (read) {
+			GASPI_CHECK(gaspi_read(segment_id,
+			                       offset + done,
+			                       rank,
+			                       segment_id,
+			                       offset + done,
+			                       chunk,
+			                       q_id,
+			                       GASPI_BLOCK));
+		}
+		else {
+			GASPI_CHECK(gaspi_write(segment_id,
+			                        offset + done,
+			                        rank,
+			                        segment_id,
+			                        offset + done,
+			                        chunk,
+			                        q_id,
+			                        GASPI_BLOCK));
+		}
+		GASPI_CHECK(gaspi_wait(q_id, GASPI_BLOCK));
+	}
+}
+
+// places the pattern on rank and clears the local copy
+void verify_push(const gaspi_segment_id_t segment_id,
+                 const size_t offset,
+                 const size_t size,
+                 const gaspi_rank_t rank,
+                 const uint64_t seed) {
+	verify_fill(segment_id, offset, size, seed);
+	transfer(0, segment_id, offset, size, rank);
+	verify_clear(segment_id, offset, size);
+}
+
+// reads the range back from rank into the cleared local copy and checks it
+int verify_pull(const gaspi_segment_id_t segment_id,
+                const size_t offset,
+                const size_t size,
+                const gaspi_rank_t rank,
+                const uint64_t seed) {
+	verify_clear(segment_id, offset, size);
+	transfer(1, segment_id, offset, size, rank);
+	return verify_check(segment_id, offset, size, seed);
+}
+
+// the sender fills its bytes with the pattern of the size, the others clear
+void verify_prepare(const gaspi_segment_id_t segment_id,
+                    const size_t bytes,
+                    const gaspi_rank_t sender,
+                    const size_t size) {
+	gaspi_rank_t my_id;
+
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	if (my_id == sender) {
+		verify_fill(segment_id, 0, bytes, verify_seed(sender, size, 0));
+	}
+	else {
+		verify_clear(segment_id, 0, bytes);
+	}
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+}
+
+// returns 0 on a rank other than the sender missing the sender's pattern
+int verify_received(const gaspi_segment_id_t segment_id,
+                    const size_t bytes,
+                    const gaspi_rank_t sender,
+                    const size_t size) {
+	gaspi_rank_t my_id;
+
+	GASPI_CHECK(gaspi_barrier(GASPI_GROUP_ALL, GASPI_BLOCK));
+	GASPI_CHECK(gaspi_proc_rank(&my_id));
+	return my_id == sender ||
+	       verify_check(segment_id, 0, bytes, verify_seed(sender, size, 0));
+}
@@ -0,0 +1,62 @@
+#ifndef __UTIL_VERIFY_H__
+#define __UTIL_VERIFY_H__
+#include <GASPI.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Payload patterns of --verify: the 8-byte word w of a segment holds
+ * seed + w * VERIFY_STRIDE, the seed mixes rank, message size and iteration,
+ * so data left over from an earlier size or iteration does not pass. The
+ * words are compared with AVX-512 or AVX2 where the CPU has them.
+ *
+ * Every verified iteration (the first one and every --verify-every N-th)
+ * refills the payload outside of the timed region. Writers clear their
+ * buffer afterwards and read the target back, readers push the pattern to
+ * the target beforehand and check what they read. Only benchmarks calling
+ * verify_every_enable() before parsing their options accept --verify-every.
+ *
+ * Benchmarks that only check what arrived by the end of the timed loop use
+ * the pattern of the message size instead, around the loop:
+ *   verify_prepare(segment_id, bytes, sender, size);  // collective
+ *   ...                                               // timed loop
+ *   if (!verify_received(segment_id, bytes, sender, size)) // collective
+ */
+#define VERIFY_STRIDE 0x9e3779b97f4a7c15ULL
+
+void verify_every_enable(void);
+int verify_every_enabled(void);
+int verify_iteration(const int i);
+uint64_t verify_seed(const gaspi_rank_t rank,
+                     const size_t size,
+                     const int iteration);
+void verify_fill(const gaspi_segment_id_t segment_id,
+                 const size_t offset,
+                 const size_t size,
+                 const uint64_t seed);
+void verify_clear(const gaspi_segment_id_t segment_id,
+                  const size_t offset,
+                  const size_t size);
+int verify_check(const gaspi_segment_id_t segment_id,
+                 const size_t offset,
+                 const size_t size,
+                 const uint64_t seed);
+void verify_push(const gaspi_segment_id_t segment_id,
+                 const size_t offset,
+                 const size_t size,
+                 const gaspi_rank_t rank,
+                 const uint64_t seed);
+int verify_pull(const gaspi_segment_id_t segment_id,
+                const size_t offset,
+                const size_t size,
+                const gaspi_rank_t rank,
+                const uint64_t seed);
+void verify_prepare(const gaspi_segment_id_t segment_id,
+                    const size_t bytes,
+                    const gaspi_rank_t sender,
+                    const size_t size);
+int verify_received(const gaspi_segment_id_t segment_id,
+                    const size_t bytes,
+                    const gaspi_rank_t sender,
+                    const size_t size);
+#endif
@@ -0,0 +1,30 @@
+#include "util_wait.h"
+#include "check.h"
+#include "util.h"
+
+static gaspi_timeout_t timeout(void) {
+	return options.polling ? GASPI_TEST : GASPI_BLOCK;
+}
+
+void wait_queue(const gaspi_queue_id_t q_id) {
+	gaspi_return_t ret;
+
+	while ((ret = gaspi_wait(q_id, timeout())) == GASPI_TIMEOUT) {
+	}
+	GASPI_CHECK(ret);
+}
+
+// waits for the notification id and resets it, returns its value
+gaspi_notification_t wait_notify(const gaspi_segment_id_t segment_id,
+                                 const gaspi_notification_id_t id) {
+	gaspi_notification_id_t first;
+	gaspi_notification_t value;
+	gaspi_return_t ret;
+
+	while ((ret = gaspi_notify_waitsome(
+	            segment_id, id, 1, &first, timeout())) == GASPI_TIMEOUT) {
+	}
+	GASPI_CHECK(ret);
+	GASPI_CHECK(gaspi_notify_reset(segment_id, first, &value));
+	return value;
+}
@@ -0,0 +1,14 @@
+#ifndef __UTIL_WAIT_H__
+#define __UTIL_WAIT_H__
+#include <GASPI.h>
+
+/*
+ * Completion waits inside the timed region of the latency benchmarks. They
+ * block in gaspi_wait and gaspi_notify_waitsome by default; with --polling
+ * they spin on GASPI_TEST instead, as latency-bound codes do to avoid the
+ * wake-up of a blocking wait.
+ */
+void wait_queue(const gaspi_queue_id_t q_id);
+gaspi_notification_t wait_notify(const gaspi_segment_id_t segment_id,
+                                 const gaspi_notification_id_t id);
+#endif